@@ -18,33 +18,170 @@
 // Do not use "using namespace std;"
 
 namespace sjtu {
+// results of to_chars / from_chars, as in <charconv>
+struct to_chars_result {
+  char *ptr;
+  std::errc ec;
+};
+struct from_chars_result {
+  const char *ptr;
+  std::errc ec;
+};
+
 class int2048 {
 private:
   static const int BASE = 10000;      // 1e4 per digit
   static const int BASE_DIGS = 4;     // digits per BASE
   std::vector<int> a;                 // little-endian digits
   bool neg = false;                   // sign flag (true if negative and not zero)
+  mutable std::string *dec = nullptr; // decimal text cache if enabled, "" when stale
 
   // helpers
   void trim();
   bool is_zero() const;
   int abs_compare(const int2048 &b) const; // -1,0,1 comparing |*this| vs |b|
+  void touch();                         // every change of value goes through here
+  const std::string *dec_text() const;  // the cached text, formatted if stale; or null
+
+  // decimal text: "00".."99" pairs, and the formatter behind print and operator<<
+  static const char DEC_PAIRS[201];
+  size_t dec_len() const;          // upper bound on the characters written
+  size_t write_dec(char *out) const;
+  static bool swar_digits(const char *c, int &hi, int &lo); // 8 digits -> two limbs
+  static const char *dec_span(const char *p, const char *last);
+  struct get_area; // a stream buffer's pending characters, for operator>>
 
   static int2048 add_abs(const int2048 &x, const int2048 &y);
   static int2048 sub_abs(const int2048 &x, const int2048 &y); // assumes |x|>=|y|
 
+  // multiplication tiers by the shorter operand: schoolbook up to KARA_MIN limbs,
+  // Karatsuba up to MUL_FFT_MIN, FFT above (Schonhage-Strassen for huge products)
+  static const int KARA_MIN = 32;
+  static const int MUL_FFT_MIN = 80;
+
+  // FFT over complex<double>
+  typedef std::complex<double> cd;
+  static cd cmul(const cd &x, const cd &y);
+  static const cd *fft_roots(int n);
+  static int fft_twiddles(int n, std::vector<cd> &lo, std::vector<cd> &hi);
+  static void fft(cd *f, int n, bool invert);
+  static void fft_cyclic(const int *x, int nx, const int *y, int ny, int n, std::vector<cd> &fa);
+  static long long fft_coef(const std::vector<cd> &fa, int i);
+
+  // Schonhage-Strassen over Z/(BASE^N + 1) for products past 2^MUL_SSA_LOG limbs,
+  // where the double FFT runs out of precision (worst rounding error, all limbs 9999:
+  // 0.09 at 2^21 product limbs, 0.25 at 2^22, 0.5 at 2^23)
+  static const int MUL_SSA_LOG = 21;
+  static void ssa_norm(int *f, int N, long long h);
+  static void ssa_butterfly(int *u, const int *v, int *d, int N);
+  static void ssa_shift(const int *f, int N, int s, int *out);
+  static void ssa_mulmod(int *f, const int *g, int N, int *tmp);
+  static void ssa_fft(int *f, int K, int N, bool invert);
+  static int2048 mul_ssa(const int2048 &x, const int2048 &y);
+
+  // column sums of limb arrays (products before carrying), full and short
+  static void conv_school(const int *x, int nx, const int *y, int ny, int m, long long *out);
+  static void conv_kara(const int *x, const int *y, int n, long long *out, int *ws, long long *wl);
+  static void conv_full(const int *x, int nx, const int *y, int ny, long long *out);
+  static void conv_lo(const int *x, int nx, const int *y, int ny, int m, long long *out);
+  static void conv_hi(const int *x, int nx, const int *y, int ny, int t, long long *out);
+  static void conv_mid(const int *x, int nx, const int *y, int ny, long long *out);
+  static void conv_mid_kara(const int *x, const int *y, int n, long long *out);
+  static void conv_exact(const int *x, int nx, const int *y, int ny, int from, int cnt, long long *out);
+  static void carry_columns(const long long *c, int m, std::vector<int> &r);
+
   static int2048 mul_simple(const int2048 &x, const int2048 &y);
+  static int2048 mul_kara(const int2048 &x, const int2048 &y);
   static int2048 mul_fft(const int2048 &x, const int2048 &y);
+  static int2048 mul_abs(const int2048 &x, const int2048 &y); // picks the tier
   static int2048 mul_by_int(const int2048 &x, int m);
 
+  static int div_by_int(int2048 &x, int m); // in place, returns the remainder
+  bool drop_limbs(size_t d);                // the low d limbs (all if fewer), true if any was not 0
+
+  // division tiers by divisor and quotient length: Knuth's algorithm D while either
+  // is below DIV_NEWTON_MIN limbs, a Newton reciprocal above
+  static const int DIV_NEWTON_MIN = 40;
+  static int2048 recip(const int2048 &w);
+  static void div_block(const int2048 &u, const int2048 &v, const int2048 &R, int p, int2048 &q, int2048 &r);
+  static void divmod_knuth(const int2048 &u, const int2048 &v, int2048 &q, int2048 &r);
+  static void divmod_newton(const int2048 &u, const int2048 &v, int2048 &q, int2048 &r);
   static void divmod_abs(const int2048 &u, const int2048 &v, int2048 &q, int2048 &r);
 
+  // radix conversion for bases other than powers of 10, in digit values 0..base-1,
+  // most significant first. k digits make a word base^k < 2^31; a power tree of
+  // base^(k * 2^t), cached per base, splits by divide and conquer down to pieces of
+  // 2^RADIX_LEAF words, so a conversion costs a few full-size multiplies and divides
+  // (the reciprocals of the powers are cached too)
+  static const int RADIX_LEAF = 4;
+  static int radix_word(int base, int &k);
+  static const std::vector<int2048> &radix_powers(int base, int t);
+  static int radix_levels(const int2048 &x, int base); // t with |x| < base^(k * 2^(t+1))
+  static void radix_split(const int2048 &x, int base, int t, int2048 &q, int2048 &r);
+  static void radix_to_digits(const int2048 &x, int base, int t, unsigned char *out);
+  static int2048 radix_from_digits(const unsigned char *d, size_t n, int base);
+  // digit characters as in GMP: 0-9a-z up to base 36, 0-9A-Za-z above
+  static char radix_char(int v, int base);
+  static int radix_digit(char c, int base); // -1 if c is not a digit of base
+
+  // |y|^k for y without trailing zero digits: square-and-multiply by y itself for
+  // one-limb y (those multiplies are linear), a sliding window of odd powers above
+  static int2048 pow_abs(const int2048 &y, unsigned long long k);
+
+  // modular multiplication for powmod: Montgomery for moduli coprime to 10 (values
+  // kept times BASE^n, reduced with a mullo and a mulhi), Barrett through div_block
+  // and a cached reciprocal otherwise
+  struct mod_ctx;
+
+  // gcd machinery on a >= b >= 0. Every step is a unimodular transform (a, b) ->
+  // (p a + q b, r a + s b), optionally left-multiplied into a gcd_matrix, so the gcd
+  // and the cofactors survive any of them. Lehmer batches run Euclid on the top
+  // 4 limbs; above HGCD_MIN limbs hgcd halves the size through recursion on the top
+  // halves, for O(M(n) log n) overall.
+  struct gcd_matrix;
+  static const int HGCD_MIN = 150;
+  static int2048 lin_comb(const int2048 &x, long long p, const int2048 &y, long long q); // known >= 0
+  static void gcd_div_step(int2048 &a, int2048 &b, gcd_matrix *M);
+  static void gcd_lehmer(int2048 &a, int2048 &b, gcd_matrix *M);
+  static void gcd_apply(gcd_matrix &M, int2048 &a, int2048 &b, gcd_matrix *T);
+  static void hgcd(const int2048 &a, const int2048 &b, gcd_matrix &M);
+  static void gcd_core(int2048 &a, int2048 &b, gcd_matrix *T);
+
+  // roots: Zimmermann's Karatsuba square root on a normalized even-length input
+  // (its one division goes Newton at large sizes), and n-th roots by Newton from an
+  // overestimate built from the root of the top part, which doubles the digits
+  static void sqrtrem_norm(const int2048 &m, int2048 &s, int2048 &r);
+  static int2048 root_abs(const int2048 &x, unsigned long n);
+
+  // combinatorics: exponents of the primes up to n (Legendre), multiplied out from
+  // the top exponent bit down, r = r^2 * (primes with that bit), each product over
+  // words of packed primes built as a balanced tree for the fast multiply tiers
+  static void sieve(unsigned long n, std::vector<int> &primes);
+  static unsigned long legendre(unsigned long n, unsigned long p); // exponent of p in n!
+  static int2048 prod_words(const int *w, size_t n);                // words below 2^31
+  // |product| of v (clobbered), always multiplying the two shortest left
+  static int2048 prod_tree(std::vector<int2048> &v);
+  static int2048 prod_signed(std::vector<int2048> &v); // the signed product, for product()
+  static int2048 prime_power_product(const std::vector<int> &p, const std::vector<unsigned long> &e);
+
+  // acc +-= |x y| with the sign of x y, in place in acc's limbs
+  static void addmul_abs(int2048 &acc, const int2048 &x, const int2048 &y, bool sub);
+
+  // binary form: a SER_HEADER-byte header (see serialize), then the limbs from the
+  // least significant, two bytes each
+  static const int SER_HEADER = 16;
+  static const int SER_VERSION = 1;
+  void ser_header(unsigned char *h) const;
+  static long long ser_read_header(const unsigned char *h, bool &neg, bool &big); // limb count, or -1
+  static bool ser_limbs(const unsigned char *p, size_t n, bool big, int *out);     // false on a bad limb
+
 public:
   // Constructors
   int2048();
   int2048(long long);
   int2048(const std::string &);
   int2048(const int2048 &);
+  ~int2048();
 
   // The parameter types of the following functions are for reference only, you can choose to use constant references or not
   // If needed, you can add other required functions yourself
@@ -54,6 +191,10 @@ public:
 
   // Read a big integer
   void read(const std::string &);
+  // The same from a character range, without copying it into a std::string
+  void read(const char *first, const char *last);
+  void read(std::string_view);
+  void read(const char *);
   // Output the stored big integer, no need for newline
   void print();
 
@@ -100,7 +241,229 @@ public:
   friend bool operator>(const int2048 &, const int2048 &);
   friend bool operator<=(const int2048 &, const int2048 &);
   friend bool operator>=(const int2048 &, const int2048 &);
+
+  // ===================================
+  // Extensions
+  // ===================================
+
+  // Keep the decimal text once formatted, for values printed often and changed
+  // rarely: operator<<, print() and to_chars then copy it. Any change of value
+  // drops it; copies of the number do not inherit the setting.
+  void cache_decimal(bool on = true);
+
+  // Scaling in place: shift_limbs multiplies by BASE^k = 10^(4k), or for k < 0
+  // divides by BASE^-k rounding down as / does; mul_pow10 and div_pow10 do the same
+  // for 10^k. Whole limbs move in one memmove and leftover digits take one pass.
+  int2048 &shift_limbs(long long);
+  int2048 &mul_pow10(unsigned long long);
+  int2048 &div_pow10(unsigned long long);
+
+  // Short products of |x| and |y|, n counted in limbs (BASE = 10^4):
+  // mullo = |x * y| mod BASE^n, mulhi = |x * y| / BASE^n rounded down.
+  // Only the columns below (mullo) or above (mulhi) the cut are computed.
+  friend int2048 mullo(const int2048 &, const int2048 &, int);
+  friend int2048 mulhi(const int2048 &, const int2048 &, int);
+
+  // x^k by left-to-right sliding-window exponentiation (0^0 = 1). Trailing zero
+  // digits are split off first, so powers of 10 (and of x * 10^j) are limb shifts.
+  friend int2048 pow(const int2048 &, unsigned long long);
+
+  // b^e mod m, the sign following m as with %. Sliding windows over the bits of e;
+  // e < 0 uses the inverse of b, and gives 0 when there is none (or m = 0).
+  friend int2048 powmod(const int2048 &, const int2048 &, const int2048 &);
+
+  // gcd >= 0 (gcd(0, 0) = 0) and lcm >= 0. gcdext also sets a * x + b * y = g with
+  // |x| <= |b| / 2g (x = sign(a), y = 0 when b = 0). modinv is the inverse of a
+  // in [0, |m|), or 0 if there is none.
+  friend int2048 gcd(const int2048 &, const int2048 &);
+  friend int2048 lcm(const int2048 &, const int2048 &);
+  friend int2048 gcdext(const int2048 &, const int2048 &, int2048 &, int2048 &);
+  friend int2048 modinv(const int2048 &, const int2048 &);
+
+  // floor(sqrt(x)) and floor(x^(1/n)), with rem = x - root^n when asked for. An odd
+  // root of x < 0 is minus the root of -x; even roots of x < 0 and n = 0 give 0.
+  friend int2048 isqrt(const int2048 &);
+  friend int2048 isqrt(const int2048 &, int2048 &);
+  friend int2048 iroot(const int2048 &, unsigned long);
+  friend int2048 iroot(const int2048 &, unsigned long, int2048 &);
+
+  // n!, n!! (0!! = 1), C(n, k) (0 for k > n) and the product of the primes <= n
+  friend int2048 factorial(unsigned long);
+  friend int2048 double_factorial(unsigned long);
+  friend int2048 binomial(unsigned long, unsigned long);
+  friend int2048 primorial(unsigned long);
+
+  // The product of [first, last) (1 if empty; any input iterators over int2048) as a
+  // tree that always multiplies the two shortest values left, so the operands of
+  // each multiply stay balanced
+  template <class It> friend int2048 product(It, It);
+  friend int2048 product(const std::vector<int2048> &);
+
+  // acc += x * y and acc -= x * y with no product temporary below the Karatsuba
+  // size: each row of the schoolbook product is added straight into acc's limbs.
+  // dot is the sum of x[i] * y[i], over [first1, last1) as std::inner_product or
+  // over the shorter vector, built the same way.
+  friend int2048 &addmul(int2048 &, const int2048 &, const int2048 &);
+  friend int2048 &submul(int2048 &, const int2048 &, const int2048 &);
+  friend int2048 dot(const std::vector<int2048> &, const std::vector<int2048> &);
+
+  // <charconv>-style conversion into and out of caller buffers: no locale, no
+  // allocation beyond the limbs (and digit scratch outside base 10), no exceptions.
+  // to_chars writes [first, ptr) or returns {last, value_too_large}; to_chars_size
+  // is the length it needs, exact in base 10 and at most one over otherwise.
+  // from_chars takes an optional '-' and the longest run of digits, and leaves the
+  // value alone with {first, invalid_argument} if there are none. Bases 2 to 62,
+  // digits as in GMP: 0-9a-z up to 36 (either case read), 0-9A-Za-z above.
+  friend size_t to_chars_size(const int2048 &, int);
+  friend to_chars_result to_chars(char *, char *, const int2048 &, int);
+  friend from_chars_result from_chars(const char *, const char *, int2048 &, int);
+
+  // Versioned binary form of 16 + 2 * ceil(digits / 4) bytes: a 16-byte header
+  // ("I2KB", version, flags with the sign and byte order, bytes and decimal digits
+  // per limb, 8-byte limb count), then two bytes per base-10^4 limb. Written
+  // little-endian; either byte order is read. The buffer versions report like
+  // to_chars / from_chars (value_too_large, invalid_argument for a bad or short
+  // input, which leaves the value alone); the stream ones set failbit.
+  friend size_t serialized_size(const int2048 &);
+  friend to_chars_result serialize(char *, char *, const int2048 &);
+  friend from_chars_result deserialize(const char *, const char *, int2048 &);
+  friend std::ostream &serialize(std::ostream &, const int2048 &);
+  friend std::istream &deserialize(std::istream &, int2048 &);
+
+  // One number from a memory region, such as a file the caller has mapped: the
+  // binary form if the region starts with its magic, otherwise decimal text after
+  // any whitespace, with an optional sign. Parsed in place, reported as from_chars
+  // (ptr just past the number, so a region of several can be walked). load_file
+  // reads a whole file with fread into one buffer and loads from that.
+  friend from_chars_result load(const char *, const char *, int2048 &);
+  friend bool load_file(const char *, int2048 &);
+
+  // Whitespace-separated numbers from a FILE *, pulled in chunks of at least
+  // chunk bytes (grown for longer tokens). next() parses each token in place with
+  // read(), so the target's limbs are reused; it returns false at the end of input.
+  class Reader {
+  public:
+    explicit Reader(std::FILE *f, size_t chunk = 1 << 16);
+    bool next(int2048 &x);
+
+  private:
+    std::FILE *f;
+    std::vector<char> buf;
+    size_t pos = 0, len = 0; // unparsed input is buf[pos, len)
+  };
+
+  // A running sum of many values, kept as signed 64-bit limb sums that are not
+  // carried on each addition, so += and -= are one pass over the addend's limbs;
+  // addmul / submul add the column sums of a product below the Karatsuba size the
+  // same way. Carries run when value() is asked for, or in place once ACC_LIMIT
+  // limbs' worth has come in, before a lane could overflow.
+  class Accumulator {
+  public:
+    Accumulator &operator+=(const int2048 &x);
+    Accumulator &operator-=(const int2048 &x);
+    Accumulator &addmul(const int2048 &x, const int2048 &y);
+    Accumulator &submul(const int2048 &x, const int2048 &y);
+    int2048 value() const;
+    void clear();
+
+  private:
+    static const long long ACC_LIMIT = 1LL << 48; // times BASE stays below 2^63
+    std::vector<long long> lane;                  // lane i weighs BASE^i
+    long long adds = 0;                           // limbs' worth per lane since the last carry
+    long long *room(size_t n, long long w);       // n lanes for w more
+    void add(const int2048 &x, bool sub);
+    void add_product(const int2048 &x, const int2048 &y, bool sub);
+    static long long carry(std::vector<long long> &l); // lanes to [0, BASE), returns the carry out
+  };
+};
+
+size_t to_chars_size(const int2048 &x, int base = 10);
+to_chars_result to_chars(char *first, char *last, const int2048 &x, int base = 10);
+from_chars_result from_chars(const char *first, const char *last, int2048 &x, int base = 10);
+int2048 factorial(unsigned long n);
+int2048 double_factorial(unsigned long n);
+int2048 binomial(unsigned long n, unsigned long k);
+int2048 primorial(unsigned long n);
+
+template <class It> int2048 product(It first, It last) {
+  std::vector<int2048> v(first, last);
+  return int2048::prod_signed(v);
+}
+
+template <class It1, class It2> int2048 dot(It1 first1, It1 last1, It2 first2) {
+  int2048 r;
+  for (; first1 != last1; ++first1, ++first2) addmul(r, *first1, *first2);
+  return r;
+}
+
+// Opt-in expression templates. lazy(x) wraps an int2048 so that +, - and * with it
+// build a tree of references instead of values; converting the tree to int2048 runs
+// the whole +/- chain through one Accumulator, with products of two plain operands
+// added as column sums, and carries once. Other operands of a product are evaluated
+// first. The tree refers to its operands, so convert it within the same statement.
+namespace expr {
+template <class D> struct Expr {
+  const D &self() const { return static_cast<const D &>(*this); }
+  operator int2048() const;
+};
+
+struct Ref : Expr<Ref> {
+  const int2048 &x;
+  explicit Ref(const int2048 &x) : x(x) {}
+};
+template <class L, class R> struct Sum : Expr<Sum<L, R>> {
+  L l;
+  R r;
+  bool minus;
+  Sum(const L &l, const R &r, bool minus) : l(l), r(r), minus(minus) {}
+};
+template <class L, class R> struct Mul : Expr<Mul<L, R>> {
+  L l;
+  R r;
+  Mul(const L &l, const R &r) : l(l), r(r) {}
 };
+template <class E> struct Neg : Expr<Neg<E>> {
+  E e;
+  explicit Neg(const E &e) : e(e) {}
+};
+
+// the value of a product operand: the referenced number itself, or a subtree evaluated
+inline const int2048 &operand(const Ref &e) { return e.x; }
+template <class E> int2048 operand(const Expr<E> &e) { return e; }
+
+inline void emit(int2048::Accumulator &acc, const Ref &e, bool sub) {
+  if (sub) acc -= e.x;
+  else acc += e.x;
+}
+template <class L, class R> void emit(int2048::Accumulator &acc, const Sum<L, R> &e, bool sub) {
+  emit(acc, e.l, sub);
+  emit(acc, e.r, sub != e.minus);
+}
+template <class L, class R> void emit(int2048::Accumulator &acc, const Mul<L, R> &e, bool sub) {
+  if (sub) acc.submul(operand(e.l), operand(e.r));
+  else acc.addmul(operand(e.l), operand(e.r));
+}
+template <class E> void emit(int2048::Accumulator &acc, const Neg<E> &e, bool sub) { emit(acc, e.e, !sub); }
+
+template <class D> Expr<D>::operator int2048() const {
+  int2048::Accumulator acc;
+  emit(acc, self(), false);
+  return acc.value();
+}
+
+template <class L, class R> Sum<L, R> operator+(const Expr<L> &l, const Expr<R> &r) { return Sum<L, R>(l.self(), r.self(), false); }
+template <class L> Sum<L, Ref> operator+(const Expr<L> &l, const int2048 &r) { return Sum<L, Ref>(l.self(), Ref(r), false); }
+template <class R> Sum<Ref, R> operator+(const int2048 &l, const Expr<R> &r) { return Sum<Ref, R>(Ref(l), r.self(), false); }
+template <class L, class R> Sum<L, R> operator-(const Expr<L> &l, const Expr<R> &r) { return Sum<L, R>(l.self(), r.self(), true); }
+template <class L> Sum<L, Ref> operator-(const Expr<L> &l, const int2048 &r) { return Sum<L, Ref>(l.self(), Ref(r), true); }
+template <class R> Sum<Ref, R> operator-(const int2048 &l, const Expr<R> &r) { return Sum<Ref, R>(Ref(l), r.self(), true); }
+template <class L, class R> Mul<L, R> operator*(const Expr<L> &l, const Expr<R> &r) { return Mul<L, R>(l.self(), r.self()); }
+template <class L> Mul<L, Ref> operator*(const Expr<L> &l, const int2048 &r) { return Mul<L, Ref>(l.self(), Ref(r)); }
+template <class R> Mul<Ref, R> operator*(const int2048 &l, const Expr<R> &r) { return Mul<Ref, R>(Ref(l), r.self()); }
+template <class E> Neg<E> operator-(const Expr<E> &e) { return Neg<E>(e.self()); }
+} // namespace expr
+
+inline expr::Ref lazy(const int2048 &x) { return expr::Ref(x); }
 } // namespace sjtu
 
 #endif
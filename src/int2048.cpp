@@ -10,6 +10,13 @@ void int2048::trim() {
 
 bool int2048::is_zero() const { return a.empty(); }
 
+void int2048::touch() { if (dec) dec->clear(); }
+
+const std::string *int2048::dec_text() const {
+  if (dec && dec->empty()) { dec->resize(dec_len()); dec->resize(write_dec(&(*dec)[0])); }
+  return dec;
+}
+
 int int2048::abs_compare(const int2048 &b) const {
   if (a.size() != b.a.size()) return a.size() < b.a.size() ? -1 : 1;
   for (int i = (int)a.size() - 1; i >= 0; --i) {
@@ -31,43 +38,103 @@ int2048::int2048(const std::string &s) { read(s); }
 
 int2048::int2048(const int2048 &o) { a = o.a; neg = o.neg; }
 
+int2048::~int2048() { delete dec; }
+
 // ===== basic ops =====
-void int2048::read(const std::string &s) {
+// SWAR: the 8 characters as one little-endian word, checked and converted in a few
+// word operations instead of 8 branches and multiplies
+bool int2048::swar_digits(const char *c, int &hi, int &lo) {
+  const unsigned char *u = (const unsigned char *)c;
+  // spelled out so it compiles to one load on little-endian targets
+  unsigned long long x = (unsigned long long)u[0] | (unsigned long long)u[1] << 8 |
+                         (unsigned long long)u[2] << 16 | (unsigned long long)u[3] << 24 |
+                         (unsigned long long)u[4] << 32 | (unsigned long long)u[5] << 40 |
+                         (unsigned long long)u[6] << 48 | (unsigned long long)u[7] << 56;
+  const unsigned long long F0 = 0xF0F0F0F0F0F0F0F0ULL;
+  if (((x & F0) | (((x + 0x0606060606060606ULL) & F0) >> 4)) != 0x3333333333333333ULL) return false;
+  x -= 0x3030303030303030ULL;
+  x = (x * 10 + (x >> 8)) & 0x00FF00FF00FF00FFULL;     // pairs
+  x = (x * 100 + (x >> 16)) & 0x0000FFFF0000FFFFULL;   // quads, first one low
+  hi = (int)(x & 0xFFFF); lo = (int)(x >> 32);
+  return true;
+}
+
+// end of the run of digits at p, eight characters to a test while they last
+const char *int2048::dec_span(const char *p, const char *last) {
+  const unsigned long long F0 = 0xF0F0F0F0F0F0F0F0ULL;
+  for (unsigned long long x; last - p >= 8; p += 8) {
+    std::memcpy(&x, p, 8);
+    if (((x & F0) | (((x + 0x0606060606060606ULL) & F0) >> 4)) != 0x3333333333333333ULL) break;
+  }
+  while (p < last && *p >= '0' && *p <= '9') ++p;
+  return p;
+}
+
+void int2048::read(const std::string &s) { read(s.data(), s.data() + s.size()); }
+void int2048::read(std::string_view s) { read(s.data(), s.data() + s.size()); }
+void int2048::read(const char *s) { read(s, s + std::strlen(s)); }
+
+void int2048::read(const char *first, const char *last) {
+  touch();
   a.clear(); neg = false;
-  int i = 0, n = (int)s.size();
+  int i = 0, n = (int)(last - first);
+  const char *c = first;
   // skip leading spaces
-  while (i < n && (s[i] == ' ' || s[i] == '\n' || s[i] == '\r' || s[i] == '\t' || s[i] == '\v' || s[i] == '\f')) ++i;
-  if (i < n && (s[i] == '+' || s[i] == '-')) { neg = (s[i] == '-'); ++i; }
+  while (i < n && (c[i] == ' ' || c[i] == '\n' || c[i] == '\r' || c[i] == '\t' || c[i] == '\v' || c[i] == '\f')) ++i;
+  if (i < n && (c[i] == '+' || c[i] == '-')) { neg = (c[i] == '-'); ++i; }
   // move to last digit
   int end = n - 1;
-  while (end >= i && !(s[end] >= '0' && s[end] <= '9')) --end;
+  while (end >= i && !(c[end] >= '0' && c[end] <= '9')) --end;
   if (end < i) { a.clear(); neg = false; return; }
-  for (int p = end; p >= i; p -= BASE_DIGS) {
+  a.resize((end - i) / BASE_DIGS + 1);
+  int *o = a.data();
+  for (int p = end; p >= i; ) {
+    if (p - 7 >= i && swar_digits(c + p - 7, o[1], o[0])) {
+      o += 2;
+      p -= 2 * BASE_DIGS;
+      continue;
+    }
+    // a group with anything but digits: those characters keep their place but add nothing
     int val = 0;
     int l = p - (BASE_DIGS - 1);
     if (l < i) l = i;
     for (int t = l; t <= p; ++t) {
-      if (s[t] >= '0' && s[t] <= '9') val = val * 10 + (s[t] - '0');
+      if (c[t] >= '0' && c[t] <= '9') val = val * 10 + (c[t] - '0');
     }
-    a.push_back(val);
+    *o++ = val;
+    p -= BASE_DIGS;
   }
   trim(); if (is_zero()) neg = false;
 }
 
-void int2048::print() {
-  if (is_zero()) { std::cout << 0; return; }
-  if (neg) std::cout << '-';
-  int i = (int)a.size() - 1;
-  std::cout << a[i];
+const char int2048::DEC_PAIRS[201] =
+    "0001020304050607080910111213141516171819202122232425262728293031323334353637383940414243444546474849"
+    "5051525354555657585960616263646566676869707172737475767778798081828384858687888990919293949596979899";
+
+size_t int2048::dec_len() const { return 1 + BASE_DIGS * std::max<size_t>(a.size(), 1); }
+
+// the whole number in one pass, two digits per table lookup
+size_t int2048::write_dec(char *out) const {
+  char *p = out;
+  if (is_zero()) { *p = '0'; return 1; }
+  if (neg) *p++ = '-';
+  int i = (int)a.size() - 1, v = a[i];
+  int len = v >= 1000 ? 4 : v >= 100 ? 3 : v >= 10 ? 2 : 1;
+  for (int k = len - 1; k >= 0; --k) { p[k] = char('0' + v % 10); v /= 10; }
+  p += len;
   for (--i; i >= 0; --i) {
-    int v = a[i];
-    // print exactly BASE_DIGS digits with leading zeros (BASE=10000 -> 4 digits)
-    char buf[5];
-    buf[4] = '\0';
-    int vv = v;
-    for (int k = 3; k >= 0; --k) { buf[k] = char('0' + (vv % 10)); vv /= 10; }
-    std::cout << buf;
+    v = a[i];
+    std::memcpy(p, DEC_PAIRS + 2 * (v / 100), 2);
+    std::memcpy(p + 2, DEC_PAIRS + 2 * (v % 100), 2);
+    p += 4;
   }
+  return p - out;
+}
+
+void int2048::print() {
+  if (const std::string *s = dec_text()) { std::cout.write(s->data(), s->size()); return; }
+  std::string buf(dec_len(), '\0');
+  std::cout.write(buf.data(), write_dec(&buf[0]));
 }
 
 // ===== absolute add/sub =====
@@ -81,7 +148,7 @@ int2048 int2048::add_abs(const int2048 &x, const int2048 &y) {
     r.a[i] = (int)(cur % BASE);
     carry = cur / BASE;
   }
-  if (carry) r.a.push_back((int)carry);
+  for (; carry; carry /= BASE) r.a.push_back((int)(carry % BASE));
   r.neg = false; return r;
 }
 
@@ -99,6 +166,7 @@ int2048 int2048::sub_abs(const int2048 &x, const int2048 &y) {
 
 // ===== operators for Integer1 =====
 int2048 &int2048::add(const int2048 &b) {
+  touch();
   bool sx = this->neg; bool sb = b.neg;
   if (sx == sb) {
     int2048 r = add_abs(*this, b);
@@ -116,6 +184,7 @@ int2048 &int2048::add(const int2048 &b) {
 int2048 add(int2048 a, const int2048 &b) { a.add(b); return a; }
 
 int2048 &int2048::minus(const int2048 &b) {
+  touch();
   bool sx = this->neg; bool sb = b.neg;
   if (sx != sb) {
     int2048 r = add_abs(*this, b);
@@ -136,22 +205,334 @@ int2048 minus(int2048 a, const int2048 &b) { a.minus(b); return a; }
 int2048 int2048::mul_simple(const int2048 &x, const int2048 &y) {
   int2048 r;
   if (x.is_zero() || y.is_zero()) return r;
-  r.a.assign(x.a.size() + y.a.size(), 0);
-  for (size_t i = 0; i < x.a.size(); ++i) {
-    long long carry = 0;
-    for (size_t j = 0; j < y.a.size() || carry; ++j) {
-      long long cur = r.a[i + j] + carry + 1LL * x.a[i] * (j < y.a.size() ? y.a[j] : 0);
-      r.a[i + j] = (int)(cur % BASE);
-      carry = cur / BASE;
+  int nx = (int)x.a.size(), ny = (int)y.a.size();
+  std::vector<long long> c(nx + ny - 1);
+  conv_school(x.a.data(), nx, y.a.data(), ny, nx + ny - 1, c.data());
+  carry_columns(c.data(), nx + ny - 1, r.a);
+  r.trim(); r.neg = false;
+  return r;
+}
+
+int2048 int2048::mul_kara(const int2048 &x, const int2048 &y) {
+  int2048 r;
+  if (x.is_zero() || y.is_zero()) return r;
+  int nx = (int)x.a.size(), ny = (int)y.a.size();
+  std::vector<long long> c(nx + ny - 1);
+  conv_full(x.a.data(), nx, y.a.data(), ny, c.data());
+  carry_columns(c.data(), nx + ny - 1, r.a);
+  r.trim(); r.neg = false;
+  return r;
+}
+
+int2048 int2048::mul_abs(const int2048 &x, const int2048 &y) {
+  size_t m = std::min(x.a.size(), y.a.size());
+  if (m <= (size_t)KARA_MIN) return mul_simple(x, y);
+  if (m <= (size_t)MUL_FFT_MIN) return mul_kara(x, y);
+  if (x.a.size() + y.a.size() > ((size_t)1 << MUL_SSA_LOG)) return mul_ssa(x, y);
+  return mul_fft(x, y);
+}
+
+// ===== FFT =====
+// Root table of the radix-2 kernel: rt[k + j] = e^(i*pi*j/k) for every level k < n.
+// Entries come straight from cos/sin so the rounding error does not build up.
+const int2048::cd *int2048::fft_roots(int n) {
+  static std::vector<cd> rt(2, cd(1, 0));
+  if ((int)rt.size() < n) {
+    const double PI = std::acos(-1.0);
+    int k = (int)rt.size();
+    rt.resize(n);
+    for (; k < n; k <<= 1)
+      for (int j = 0; j < k; ++j) rt[k + j] = std::polar(1.0, PI * j / k);
+  }
+  return rt.data();
+}
+
+// plain product; std::complex's operator* carries inf/nan recovery we never need
+int2048::cd int2048::cmul(const cd &x, const cd &y) {
+  return cd(x.real() * y.real() - x.imag() * y.imag(), x.real() * y.imag() + x.imag() * y.real());
+}
+
+// Forward: decimation in frequency, natural order in, bit-reversed order out.
+// Inverse: decimation in time, bit-reversed in, natural out, left unscaled (times n).
+// Pairing the two saves the bit-reversal permutation in both directions.
+void int2048::fft(cd *f, int n, bool invert) {
+  const cd *rt = fft_roots(n);
+  if (!invert) {
+    for (int k = n >> 1; k >= 1; k >>= 1)
+      for (int i = 0; i < n; i += 2 * k)
+        for (int j = 0; j < k; ++j) {
+          cd u = f[i + j], v = f[i + j + k];
+          f[i + j] = u + v;
+          f[i + j + k] = cmul(u - v, rt[k + j]);
+        }
+  } else {
+    for (int k = 1; k < n; k <<= 1)
+      for (int i = 0; i < n; i += 2 * k)
+        for (int j = 0; j < k; ++j) {
+          cd u = f[i + j], v = cmul(f[i + j + k], std::conj(rt[k + j]));
+          f[i + j] = u + v;
+          f[i + j + k] = u - v;
+        }
+  }
+}
+
+// Twiddles e^(2*pi*i*e/n) for any e < n as hi[e >> ls] * lo[e & (2^ls - 1)]:
+// two sqrt(n)-sized tables instead of one of size n, still accurate to an ulp or so.
+// Returns ls.
+int int2048::fft_twiddles(int n, std::vector<cd> &lo, std::vector<cd> &hi) {
+  const double PI = std::acos(-1.0);
+  int ls = 0;
+  while ((1 << (2 * ls)) < n) ++ls;
+  lo.resize(1 << ls); hi.resize((n >> ls) + 1);
+  for (int r = 0; r < (1 << ls); ++r) lo[r] = std::polar(1.0, 2 * PI * r / n);
+  for (int q = 0; q <= (n >> ls); ++q) hi[q] = std::polar(1.0, 2 * PI * ((double)q * (1 << ls)) / n);
+  return ls;
+}
+
+// Cyclic convolution of length n (a power of two >= 4) by real-input packing: the
+// limbs of x are folded into a half-length complex array (even limbs in the real
+// part, odd limbs in the imaginary part), the spectrum of the real sequence is
+// untangled from it, and the product spectrum is folded back the same way, so it
+// takes three in-place FFTs of n/2 points (two when squaring, x == y).
+// Coefficient i of x * y mod (X^n - 1) is left in the real (even i) or imaginary
+// (odd i) part of fa[i >> 1], scaled by n/2.
+void int2048::fft_cyclic(const int *x, int nx, const int *y, int ny, int n, std::vector<cd> &fa) {
+  bool sqr = x == y && nx == ny;
+  int h = n >> 1;
+  std::vector<cd> fb;
+  fa.assign(h, cd(0, 0));
+  for (int i = 0; i < nx; ++i) {
+    if (i & 1) fa[i >> 1].imag(x[i]); else fa[i >> 1].real(x[i]);
+  }
+  fft(fa.data(), h, false);
+  if (!sqr) {
+    fb.resize(h);
+    for (int i = 0; i < ny; ++i) {
+      if (i & 1) fb[i >> 1].imag(y[i]); else fb[i >> 1].real(y[i]);
+    }
+    fft(fb.data(), h, false);
+  }
+  const cd *pb = sqr ? fa.data() : fb.data();
+  std::vector<cd> lo, hi;
+  int ls = fft_twiddles(n, lo, hi);
+  // spectrum slot k of the packed product from slots k and h-k of the operands;
+  // w = e^(2*pi*i*k/n)
+  auto fold = [&](cd ak, cd akc, cd bk, cd bkc, cd w) {
+    cd ex = (ak + std::conj(akc)) * 0.5, ox = cmul(ak - std::conj(akc), cd(0, -0.5));
+    cd ey = (bk + std::conj(bkc)) * 0.5, oy = cmul(bk - std::conj(bkc), cd(0, -0.5));
+    ox = cmul(ox, w); oy = cmul(oy, w);
+    cd p0 = cmul(ex + ox, ey + oy), p1 = cmul(ex - ox, ey - oy); // P_k, P_{k+h}
+    return (p0 + p1) * 0.5 + cmul((p0 - p1) * 0.5, cmul(cd(0, 1), std::conj(w)));
+  };
+  // slots are in bit-reversed order; rev(h-k) = ~rev(k-1) within log2(h) bits
+  for (int k = 0, rk = 0, prev = 0; k <= h / 2; ++k) {
+    if (k) {
+      int bit = h >> 1;
+      for (; rk & bit; bit >>= 1) rk ^= bit;
+      rk ^= bit;
     }
+    int rc = k ? (h - 1) ^ prev : 0;
+    prev = rk;
+    int kc = (h - k) & (h - 1);
+    cd ak = fa[rk], akc = fa[rc], bk = pb[rk], bkc = pb[rc];
+    fa[rk] = fold(ak, akc, bk, bkc, cmul(hi[k >> ls], lo[k & ((1 << ls) - 1)]));
+    if (kc != k) fa[rc] = fold(akc, ak, bkc, bk, cmul(hi[kc >> ls], lo[kc & ((1 << ls) - 1)]));
+  }
+  std::vector<cd>().swap(fb);
+  fft(fa.data(), h, true);
+}
+
+// Peak memory with n the power of two >= nx + ny - 1: the two n/2-point arrays,
+// 16n bytes (8n when squaring), plus the 4(nx + ny)-byte result and the cached
+// n/2-entry root table (8n bytes, kept between calls). Two 10^200000-digit operands
+// give n = 2^17: 2 MiB of arrays, half of what two n-point complex arrays take.
+int2048 int2048::mul_fft(const int2048 &x, const int2048 &y) {
+  int2048 r;
+  if (x.is_zero() || y.is_zero()) return r;
+  int nx = (int)x.a.size(), ny = (int)y.a.size(), need = nx + ny - 1, n = 4;
+  while (n < need) n <<= 1;
+  int h = n >> 1;
+  std::vector<cd> fa;
+  bool sqr = &x == &y || x.a == y.a;
+  fft_cyclic(x.a.data(), nx, sqr ? x.a.data() : y.a.data(), ny, n, fa);
+  r.a.resize(nx + ny);
+  long long carry = 0;
+  for (int i = 0; i < nx + ny; ++i) {
+    double v = i < need ? (i & 1 ? fa[i >> 1].imag() : fa[i >> 1].real()) / h : 0;
+    long long cur = carry + (long long)(v + 0.5);
+    r.a[i] = (int)(cur % BASE);
+    carry = cur / BASE;
   }
   r.trim(); r.neg = false;
   return r;
 }
 
-int2048 int2048::mul_fft(const int2048 &x, const int2048 &y) {
-  // For now, fallback to schoolbook. Can be optimized later.
-  return mul_simple(x, y);
+// ===== Schonhage-Strassen =====
+// An element of Z/(BASE^N + 1) takes N + 1 limbs holding a value in [0, BASE^N].
+// BASE^N = -1 there, so BASE is a 2N-th root of unity and the transform's twiddles
+// are negacyclic limb shifts: all exact, with no rounding bound on the length.
+
+// f[0..N) proper limbs plus an overflow h: reduce lo + h * BASE^N = lo - h
+void int2048::ssa_norm(int *f, int N, long long h) {
+  long long c = -h;
+  f[N] = 0;
+  while (c) {
+    for (int i = 0; i < N && c; ++i) {
+      long long t = f[i] + c;
+      c = t >= 0 ? t / BASE : -((BASE - 1 - t) / BASE);
+      f[i] = (int)(t - c * BASE);
+    }
+    if (c == 1) { // lo + BASE^N: BASE^N itself is kept, else it is lo - 1
+      bool zero = true;
+      for (int i = 0; i < N && zero; ++i) zero = f[i] == 0;
+      if (zero) { f[N] = 1; return; }
+    }
+    c = -c;
+  }
+}
+
+// (u, d) = (u + v, u - v); d may be v
+void int2048::ssa_butterfly(int *u, const int *v, int *d, int N) {
+  int cs = 0, cd = 0;
+  for (int i = 0; i < N; ++i) {
+    int x = u[i], y = v[i], s = x + y + cs, t = x - y - cd;
+    cs = s >= BASE; cd = t < 0;
+    u[i] = s - cs * BASE; d[i] = t + cd * BASE;
+  }
+  long long hs = u[N] + v[N] + cs, hd = u[N] - v[N] - cd;
+  ssa_norm(u, N, hs);
+  ssa_norm(d, N, hd);
+}
+
+// out = f * BASE^s for 0 <= s < 2N. With f = lo + hi * BASE^(N-s), f * BASE^s = lo * BASE^s - hi.
+void int2048::ssa_shift(const int *f, int N, int s, int *out) {
+  if (s == 0) { std::memcpy(out, f, sizeof(int) * (N + 1)); return; }
+  bool neg = s >= N;
+  if (neg) s -= N;
+  int borrow = 0;
+  for (int i = 0; i <= s && i < N; ++i) { // hi, plus the bottom limb of lo at i == s
+    int sh = i == s ? f[0] : 0, hv = f[N - s + i];
+    int t = (neg ? hv - sh : sh - hv) - borrow;
+    borrow = t < 0; out[i] = t + borrow * BASE;
+  }
+  for (int i = s + 1; i < N; ++i) {
+    int t = (neg ? -f[i - s] : f[i - s]) - borrow;
+    borrow = t < 0; out[i] = t + borrow * BASE;
+  }
+  ssa_norm(out, N, -borrow);
+}
+
+// f = f * g mod BASE^N + 1, N a power of two. Right-angle convolution: with
+// w = e^(i pi / N), z_j = (f_j + i f_(j+N/2)) w^j turns the negacyclic product of
+// length N into a cyclic one of N/2 complex points, which is half of what the
+// packed real transform of the 2N-limb product would take.
+void int2048::ssa_mulmod(int *f, const int *g, int N, int *tmp) {
+  if (f[N] || g[N]) { // BASE^N = -1
+    if (f[N] && g[N]) { std::memset(f, 0, sizeof(int) * (N + 1)); f[0] = 1; return; }
+    if (f[N]) { ssa_shift(g, N, N, f); return; }
+    ssa_shift(f, N, N, tmp);
+    std::memcpy(f, tmp, sizeof(int) * (N + 1));
+    return;
+  }
+  int h = N / 2;
+  bool sqr = f == g;
+  const cd *w = fft_roots(2 * N) + N;
+  std::vector<cd> za(h), zb(sqr ? 0 : h);
+  for (int j = 0; j < h; ++j) za[j] = cmul(cd(f[j], f[j + h]), w[j]);
+  fft(za.data(), h, false);
+  if (!sqr) {
+    for (int j = 0; j < h; ++j) zb[j] = cmul(cd(g[j], g[j + h]), w[j]);
+    fft(zb.data(), h, false);
+  }
+  for (int j = 0; j < h; ++j) za[j] = cmul(za[j], sqr ? za[j] : zb[j]);
+  fft(za.data(), h, true);
+  w = fft_roots(2 * N) + N;
+  long long carry = 0;
+  for (int half = 0; half < 2; ++half) {
+    for (int j = 0; j < h; ++j) {
+      cd z = cmul(za[j], std::conj(w[j])) / (double)h;
+      long long t = (long long)std::floor((half ? z.imag() : z.real()) + 0.5) + carry;
+      carry = t >= 0 ? t / BASE : -((BASE - 1 - t) / BASE);
+      f[half * h + j] = (int)(t - carry * BASE);
+    }
+  }
+  ssa_norm(f, N, carry);
+}
+
+// K elements of N + 1 limbs; the root of order K is BASE^(2N/K). Forward is DIF with
+// bit-reversed output, inverse DIT from bit-reversed input and unscaled, as in fft.
+void int2048::ssa_fft(int *f, int K, int N, bool invert) {
+  size_t W = N + 1;
+  std::vector<int> tmp(W);
+  for (int len = invert ? 2 : K; len >= 2 && len <= K; len = invert ? len << 1 : len >> 1) {
+    int half = len >> 1, step = 2 * N / len;
+    for (int i = 0; i < K; i += len) {
+      for (int j = 0; j < half; ++j) {
+        int *u = f + (i + j) * W, *v = u + half * W;
+        if (!j) ssa_butterfly(u, v, v, N);
+        else if (!invert) {
+          ssa_butterfly(u, v, tmp.data(), N);
+          ssa_shift(tmp.data(), N, j * step, v);
+        } else {
+          ssa_shift(v, N, 2 * N - j * step, tmp.data());
+          ssa_butterfly(u, tmp.data(), v, N);
+        }
+      }
+    }
+  }
+}
+
+// x and y cut into M-limb pieces, at most K coefficients of x * y, each below
+// K * BASE^(2M). With K * (that bound) < BASE^N the cyclic convolution mod
+// BASE^N + 1 is exact even before dividing out the K of the inverse transform, and
+// K | 2N puts the K-th roots of unity among the powers of BASE. Memory is the two
+// K x (N + 1) limb arrays, K * N between 2 and 4 times the product length: 8 to 16
+// bytes per product limb each, about what mul_fft's two complex arrays take.
+int2048 int2048::mul_ssa(const int2048 &x, const int2048 &y) {
+  int nx = (int)x.a.size(), ny = (int)y.a.size(), T = nx + ny;
+  // N a power of two for the pointwise transforms; of the (K, N) that fit, the least
+  // work K * N, then K closest to N. N stays far inside the double FFT's precision.
+  int K = 0, M = 0, N = 0;
+  for (int n = 16; n <= (1 << 16); n <<= 1) {
+    int m = (n - 3) / 2, kk = 4; // K^2 < BASE^3: three guard limbs above 2M
+    while ((long long)(kk - 1) * m < T) kk <<= 1;
+    if (kk / 2 > n) continue;
+    long long w = (long long)kk * n, bw = (long long)K * N;
+    if (!N || w < bw || (w == bw && std::max(kk, n) < std::max(K, N))) { K = kk; M = m; N = n; }
+  }
+  size_t W = N + 1;
+  bool sqr = &x == &y || x.a == y.a;
+  auto split = [&](const int2048 &z, std::vector<int> &f) {
+    f.assign(K * W, 0);
+    for (int i = 0; (size_t)i * M < z.a.size(); ++i)
+      std::memcpy(f.data() + i * W, z.a.data() + (size_t)i * M, sizeof(int) * std::min((size_t)M, z.a.size() - (size_t)i * M));
+    ssa_fft(f.data(), K, N, false);
+  };
+  std::vector<int> fx, fy;
+  split(x, fx);
+  if (!sqr) split(y, fy);
+  std::vector<int> tmp(W);
+  for (int i = 0; i < K; ++i)
+    ssa_mulmod(fx.data() + i * W, (sqr ? fx : fy).data() + i * W, N, tmp.data());
+  std::vector<int>().swap(fy);
+  ssa_fft(fx.data(), K, N, true);
+  int2048 res;
+  res.a.assign((size_t)K * M + W + 1, 0);
+  for (int j = 0; j < K; ++j) {
+    int *e = fx.data() + j * W, *o = res.a.data() + (size_t)j * M;
+    long long rem = 0;
+    for (int i = N; i >= 0; --i) {
+      long long cur = e[i] + rem * BASE;
+      e[i] = (int)(cur / K); rem = cur % K;
+    }
+    int carry = 0;
+    for (size_t i = 0; i < W || carry; ++i) {
+      int t = o[i] + (i < W ? e[i] : 0) + carry;
+      carry = t >= BASE; o[i] = t - carry * BASE;
+    }
+  }
+  res.trim();
+  return res;
 }
 
 int2048 int2048::mul_by_int(const int2048 &x, int m) {
@@ -163,47 +544,1283 @@ int2048 int2048::mul_by_int(const int2048 &x, int m) {
     r.a[i] = (int)(cur % BASE);
     carry = cur / BASE;
   }
-  if (carry) r.a.push_back((int)carry);
+  for (; carry; carry /= BASE) r.a.push_back((int)(carry % BASE));
   r.neg = false; return r;
 }
 
+int int2048::div_by_int(int2048 &x, int m) {
+  long long rem = 0;
+  for (int i = (int)x.a.size() - 1; i >= 0; --i) {
+    long long cur = x.a[i] + rem * BASE;
+    x.a[i] = (int)(cur / m);
+    rem = cur % m;
+  }
+  x.trim();
+  return (int)rem;
+}
+
+// ===== column sums and short products =====
+// The conv_* kernels write the column sums c_j = sum x_i * y_(j-i) of two limb
+// arrays without carrying; carry_columns turns them back into limbs. A column is at
+// most min(nx, ny) * 9999^2, far below 2^63 for every size the FFT can handle.
+
+void int2048::carry_columns(const long long *c, int m, std::vector<int> &r) {
+  r.resize(m);
+  long long carry = 0;
+  for (int i = 0; i < m; ++i) {
+    long long cur = c[i] + carry;
+    r[i] = (int)(cur % BASE);
+    carry = cur / BASE;
+  }
+  while (carry) { r.push_back((int)(carry % BASE)); carry /= BASE; }
+}
+
+long long int2048::fft_coef(const std::vector<cd> &fa, int i) {
+  double v = (i & 1 ? fa[i >> 1].imag() : fa[i >> 1].real()) / fa.size();
+  return (long long)std::floor(v + 0.5);
+}
+
+// columns 0..m-1 only
+void int2048::conv_school(const int *x, int nx, const int *y, int ny, int m, long long *out) {
+  std::memset(out, 0, sizeof(long long) * m);
+  for (int i = 0; i < nx && i < m; ++i) {
+    long long xi = x[i];
+    long long *o = out + i;
+    int lim = std::min(ny, m - i);
+    for (int j = 0; j < lim; ++j) o[j] += xi * y[j];
+  }
+}
+
+// both operands n limbs, 2n - 1 columns out; ws/wl are scratch of 2n + 64 entries
+void int2048::conv_kara(const int *x, const int *y, int n, long long *out, int *ws, long long *wl) {
+  if (n <= KARA_MIN) { conv_school(x, n, y, n, 2 * n - 1, out); return; }
+  int k = n / 2, h = n - k; // low halves k limbs, high halves h >= k
+  conv_kara(x, y, k, out, ws, wl);
+  out[2 * k - 1] = 0;
+  conv_kara(x + k, y + k, h, out + 2 * k, ws, wl);
+  int *s = ws; // x0 + x1 | y0 + y1
+  long long *mid = wl;
+  for (int i = 0; i < h; ++i) {
+    s[i] = x[k + i] + (i < k ? x[i] : 0);
+    s[h + i] = y[k + i] + (i < k ? y[i] : 0);
+  }
+  conv_kara(s, x == y ? s : s + h, h, mid, ws + 2 * h, wl + 2 * h);
+  for (int i = 0; i < 2 * k - 1; ++i) mid[i] -= out[i];
+  for (int i = 0; i < 2 * h - 1; ++i) mid[i] -= out[2 * k + i];
+  for (int i = 0; i < 2 * h - 1; ++i) out[k + i] += mid[i];
+}
+
+// The cyclic transforms below stop being exact past 2^MUL_SSA_LOG points, so longer
+// products come from mul_abs: columns from..from+cnt-1 of the carried product, the
+// limb above folded into the last. A window reaching the top keeps the value of
+// x * y / BASE^from (carries from below included); a shorter one is right mod BASE^cnt.
+void int2048::conv_exact(const int *x, int nx, const int *y, int ny, int from, int cnt, long long *out) {
+  int2048 X, Y;
+  X.a.assign(x, x + nx); X.trim();
+  Y.a.assign(y, y + ny); Y.trim();
+  int2048 P = mul_abs(X, Y);
+  int np = (int)P.a.size();
+  for (int i = 0; i < cnt; ++i) out[i] = from + i < np ? P.a[from + i] : 0;
+  if (from + cnt < np) out[cnt - 1] += (long long)P.a[from + cnt] * BASE;
+}
+
+// all nx + ny - 1 columns
+void int2048::conv_full(const int *x, int nx, const int *y, int ny, long long *out) {
+  if (nx < ny) { std::swap(x, y); std::swap(nx, ny); }
+  int m = nx + ny - 1;
+  if (ny <= KARA_MIN) { conv_school(x, nx, y, ny, m, out); return; }
+  if (ny > MUL_FFT_MIN) {
+    int n = 4;
+    while (n < m) n <<= 1;
+    if (n > (1 << MUL_SSA_LOG)) { conv_exact(x, nx, y, ny, 0, m, out); return; }
+    std::vector<cd> fa;
+    fft_cyclic(x, nx, y, ny, n, fa);
+    for (int i = 0; i < m; ++i) out[i] = fft_coef(fa, i);
+    return;
+  }
+  // Karatsuba on ny-limb slices of the longer operand
+  std::vector<int> ws(2 * ny + 64);
+  std::vector<long long> wl(2 * ny + 64);
+  if (nx == ny) { conv_kara(x, y, ny, out, ws.data(), wl.data()); return; }
+  std::memset(out, 0, sizeof(long long) * m);
+  std::vector<long long> part(2 * ny - 1);
+  std::vector<int> pad;
+  for (int i = 0; i < nx; i += ny) {
+    int len = std::min(ny, nx - i);
+    const int *xs = x + i;
+    if (len < ny) { pad.assign(xs, xs + len); pad.resize(ny, 0); xs = pad.data(); }
+    conv_kara(xs, y, ny, part.data(), ws.data(), wl.data());
+    for (int j = 0; j < len + ny - 1; ++j) out[i + j] += part[j];
+  }
+}
+
+// Low short product: columns 0..m-1 only, skipping the terms that land above.
+// Karatsuba tier: Mulders' split, x0 * y0 in full with k ~ 0.7m plus the two cross
+// terms as short products of m - k columns. Transform tier: one cyclic convolution
+// of length L >= m; the columns >= L that wrap onto the bottom are a short high
+// product of the top limbs and get subtracted back out. That only pays while at most
+// L/4 columns wrap; past that the product is taken in full.
+void int2048::conv_lo(const int *x, int nx, const int *y, int ny, int m, long long *out) {
+  nx = std::min(nx, m); ny = std::min(ny, m);
+  if (nx < ny) { std::swap(x, y); std::swap(nx, ny); }
+  if (ny == 0) { std::memset(out, 0, sizeof(long long) * m); return; }
+  int full = nx + ny - 1;
+  if (full <= m) {
+    conv_full(x, nx, y, ny, out);
+    std::memset(out + full, 0, sizeof(long long) * (m - full));
+    return;
+  }
+  if (ny <= KARA_MIN) { conv_school(x, nx, y, ny, m, out); return; }
+  if (m <= 2 * MUL_FFT_MIN) {
+    int k = (7 * m + 9) / 10, kx = std::min(nx, k), ky = std::min(ny, k);
+    std::vector<long long> t(kx + ky - 1), c(m - k);
+    conv_full(x, kx, y, ky, t.data());
+    for (int i = 0; i < m; ++i) out[i] = i < kx + ky - 1 ? t[i] : 0;
+    if (nx > k) {
+      conv_lo(x + k, nx - k, y, ny, m - k, c.data());
+      for (int i = 0; i < m - k; ++i) out[k + i] += c[i];
+    }
+    if (ny > k) {
+      conv_lo(x, nx, y + k, ny - k, m - k, c.data());
+      for (int i = 0; i < m - k; ++i) out[k + i] += c[i];
+    }
+    return;
+  }
+  int L = 4;
+  while (L < m) L <<= 1;
+  if (L > (1 << MUL_SSA_LOG)) { conv_exact(x, nx, y, ny, 0, m, out); return; }
+  int over = full - L; // columns that wrap around
+  if (over > L / 4) {
+    // the correction would cost about as much as the longer transform
+    std::vector<long long> t(full);
+    conv_full(x, nx, y, ny, t.data());
+    std::memcpy(out, t.data(), sizeof(long long) * m);
+    return;
+  }
+  std::vector<cd> fa;
+  fft_cyclic(x, nx, y, ny, L, fa);
+  for (int i = 0; i < m; ++i) out[i] = fft_coef(fa, i);
+  if (over > 0) {
+    std::vector<long long> w(over);
+    conv_hi(x, nx, y, ny, L, w.data());
+    for (int i = 0; i < over && i < m; ++i) out[i] -= w[i];
+  }
+}
+
+// High short product: columns t..nx+ny-2 into out[0..), as the low short product
+// of the limb-reversed operands.
+void int2048::conv_hi(const int *x, int nx, const int *y, int ny, int t, long long *out) {
+  int cnt = nx + ny - 1 - t;
+  if (cnt <= 0) return;
+  bool sqr = x == y && nx == ny;
+  int rx = std::min(nx, cnt), ry = std::min(ny, cnt);
+  // conv_lo on the reversed limbs would reduce mod BASE^cnt there, losing the top
+  if (rx + ry - 1 > (1 << MUL_SSA_LOG)) { conv_exact(x, nx, y, ny, t, cnt, out); return; }
+  std::vector<int> xr(rx), yr(sqr ? 0 : ry);
+  for (int i = 0; i < rx; ++i) xr[i] = x[nx - 1 - i];
+  for (int i = 0; i < (int)yr.size(); ++i) yr[i] = y[ny - 1 - i];
+  std::vector<long long> rc(cnt);
+  conv_lo(xr.data(), rx, sqr ? xr.data() : yr.data(), ry, cnt, rc.data());
+  for (int i = 0; i < cnt; ++i) out[i] = rc[cnt - 1 - i];
+}
+
+// Middle product: the nx - ny + 1 columns ny-1..nx-1 of x * y (nx >= ny), the ones
+// every limb of y reaches, into out[0..). By the transposition principle these cost
+// about as much as an ny x ny product rather than the full nx x ny one.
+void int2048::conv_mid(const int *x, int nx, const int *y, int ny, long long *out) {
+  int r = nx - ny + 1;
+  if (std::min(r, ny) > MUL_FFT_MIN) {
+    // a cyclic length L >= nx wraps columns >= L onto 0..nx+ny-2-L, all below ny - 1
+    int L = 4;
+    while (L < nx) L <<= 1;
+    if (L > (1 << MUL_SSA_LOG)) { conv_exact(x, nx, y, ny, ny - 1, r, out); return; }
+    std::vector<cd> fa;
+    fft_cyclic(x, nx, y, ny, L, fa);
+    for (int i = 0; i < r; ++i) out[i] = fft_coef(fa, ny - 1 + i);
+    return;
+  }
+  if (std::min(r, ny) <= KARA_MIN) {
+    for (int i = 0; i < r; ++i) {
+      long long s = 0;
+      const int *xi = x + i + ny - 1;
+      for (int j = 0; j < ny; ++j) s += (long long)xi[-j] * y[j];
+      out[i] = s;
+    }
+    return;
+  }
+  if (r == ny) { conv_mid_kara(x, y, ny, out); return; }
+  if (r > ny) {
+    // ny columns at a time, each from its own 2ny - 1 limbs of x
+    for (int i = 0; i < r; i += ny) conv_mid(x + i, std::min(ny, r - i) + ny - 1, y, ny, out + i);
+    return;
+  }
+  // r-limb slices of y, slice k against the window of x starting at ny - r - k*r;
+  // z zero limbs below y (and above x) make the slices come out even
+  int z = (r - ny % r) % r;
+  std::vector<int> xp, yp;
+  if (z) {
+    xp.assign(x, x + nx); xp.resize(nx + z, 0); x = xp.data();
+    yp.assign(z, 0); yp.insert(yp.end(), y, y + ny); y = yp.data(); ny += z;
+  }
+  std::vector<long long> part(r);
+  std::memset(out, 0, sizeof(long long) * r);
+  for (int k = 0; k * r < ny; ++k) {
+    conv_mid_kara(x + ny - r - k * r, y + k * r, r, part.data());
+    for (int i = 0; i < r; ++i) out[i] += part[i];
+  }
+}
+
+// x has 2n - 1 limbs, y has n. Hanrot-Quercia-Zimmermann: with y = y0 + y1 X^k and
+// x0, x1, x2 the windows of x at 0, k, 2k, the low half is MP(x0 + x1, y1) + b and
+// the high half MP(x1 + x2, y0) - b, b = MP(x1, y0 - y1). Odd n gets a zero limb
+// below y and two above x.
+void int2048::conv_mid_kara(const int *x, const int *y, int n, long long *out) {
+  if (n <= KARA_MIN) { conv_mid(x, 2 * n - 1, y, n, out); return; }
+  if (n & 1) {
+    std::vector<int> xp(x, x + 2 * n - 1), yp(n + 1, 0);
+    xp.resize(2 * n + 1, 0);
+    std::memcpy(yp.data() + 1, y, sizeof(int) * n);
+    std::vector<long long> o(n + 1);
+    conv_mid_kara(xp.data(), yp.data(), n + 1, o.data());
+    std::memcpy(out, o.data(), sizeof(long long) * n);
+    return;
+  }
+  int k = n / 2;
+  std::vector<int> s(2 * k - 1), d(k);
+  std::vector<long long> b(k);
+  for (int i = 0; i < k; ++i) d[i] = y[i] - y[k + i];
+  conv_mid_kara(x + k, d.data(), k, b.data());
+  for (int i = 0; i < 2 * k - 1; ++i) s[i] = x[i] + x[k + i];
+  conv_mid_kara(s.data(), y + k, k, out);
+  for (int i = 0; i < 2 * k - 1; ++i) s[i] = x[k + i] + x[2 * k + i];
+  conv_mid_kara(s.data(), y, k, out + k);
+  for (int i = 0; i < k; ++i) { out[i] += b[i]; out[k + i] -= b[i]; }
+}
+
+int2048 mullo(const int2048 &x, const int2048 &y, int n) {
+  int2048 r;
+  if (n <= 0 || x.is_zero() || y.is_zero()) return r;
+  int nx = std::min((int)x.a.size(), n), ny = std::min((int)y.a.size(), n);
+  int m = std::min(n, nx + ny - 1);
+  std::vector<long long> c(m);
+  int2048::conv_lo(x.a.data(), nx, (&x == &y ? x : y).a.data(), ny, m, c.data());
+  int2048::carry_columns(c.data(), m, r.a);
+  if ((int)r.a.size() > n) r.a.resize(n);
+  r.trim();
+  return r;
+}
+
+int2048 mulhi(const int2048 &x, const int2048 &y, int n) {
+  int2048 r;
+  if (n < 0) n = 0;
+  int nx = (int)x.a.size(), ny = (int)y.a.size();
+  if (x.is_zero() || y.is_zero() || n >= nx + ny) return r;
+  // Columns from t = n - G up are summed exactly. The dropped ones below add less
+  // than t * BASE in units of BASE^t, so unless the G guard limbs sit within that
+  // distance of a carry the limbs above them are exact; otherwise multiply in full.
+  const int G = 3;
+  const long long GUARD = (long long)int2048::BASE * int2048::BASE * int2048::BASE;
+  int t = n - G;
+  if (t > 0) {
+    int cnt = nx + ny - 1 - t;
+    std::vector<long long> c(cnt);
+    int2048::conv_hi(x.a.data(), nx, (&x == &y ? x : y).a.data(), ny, t, c.data());
+    int2048::carry_columns(c.data(), cnt, r.a);
+    long long low = r.a[0] + (long long)r.a[1] * int2048::BASE + (long long)r.a[2] * int2048::BASE * int2048::BASE;
+    if (low <= GUARD - (long long)t * int2048::BASE) {
+      r.a.erase(r.a.begin(), r.a.begin() + G);
+      r.trim();
+      return r;
+    }
+  }
+  r = int2048::mul_abs(x, y);
+  return r.shift_limbs(-n);
+}
+
 // ===== division (absolute) =====
+// The divisors below are normalized: top limb >= BASE / 2.
+
+// Knuth's algorithm D: each quotient limb is estimated from the top two limbs of the
+// remainder and the divisor, then corrected at most once by adding v back.
+void int2048::divmod_knuth(const int2048 &u, const int2048 &v, int2048 &q, int2048 &r) {
+  int n = (int)u.a.size(), m = (int)v.a.size();
+  std::vector<int> un(u.a);
+  un.push_back(0);
+  const int *vn = v.a.data();
+  long long vt = vn[m - 1], vs = vn[m - 2];
+  q.a.assign(n - m + 1, 0); q.neg = false;
+  for (int j = n - m; j >= 0; --j) {
+    long long num = (long long)un[j + m] * BASE + un[j + m - 1];
+    long long qh = num / vt, rh = num % vt;
+    while (qh >= BASE || qh * vs > rh * BASE + un[j + m - 2]) {
+      --qh; rh += vt;
+      if (rh >= BASE) break;
+    }
+    long long borrow = 0;
+    for (int i = 0; i < m; ++i) {
+      long long t = un[i + j] - qh * vn[i] - borrow;
+      borrow = t < 0 ? (BASE - 1 - t) / BASE : 0;
+      un[i + j] = (int)(t + borrow * BASE);
+    }
+    long long top = un[j + m] - borrow;
+    if (top < 0) {
+      --qh;
+      long long carry = 0;
+      for (int i = 0; i < m; ++i) {
+        long long t = un[i + j] + vn[i] + carry;
+        carry = t >= BASE;
+        un[i + j] = (int)(t - carry * BASE);
+      }
+      top += carry;
+    }
+    un[j + m] = (int)top;
+    q.a[j] = (int)qh;
+  }
+  q.trim();
+  r.a.assign(un.begin(), un.begin() + m); r.neg = false;
+  r.trim();
+}
+
+// BASE^(2p) / w to within a few units, w of p limbs. Newton from the top h ~ p/2
+// limbs: with R_h ~ BASE^(2h) / w_h and w * R_h = BASE^(p+h) + e,
+// R = R_h * BASE^(p-h) - R_h * e / BASE^(2h). Since |e| < 6 * BASE^p, e is read off
+// the middle product's columns h-G..p (the lower ones only carry in) and R_h * e
+// needs only its high half, so a step costs about one p-limb multiplication.
+int2048 int2048::recip(const int2048 &w) {
+  int p = (int)w.a.size();
+  // the step needs h = p/2 + 2 < p, so tiny p stay with Knuth whatever DIV_NEWTON_MIN is
+  if (p < DIV_NEWTON_MIN || p <= 4) {
+    int2048 u, q, r;
+    u.a.assign(2 * p + 1, 0); u.a[2 * p] = 1;
+    divmod_knuth(u, w, q, r);
+    return q;
+  }
+  const int G = 3;
+  int h = p / 2 + 2, l = p - h; // the +2 keeps the squared error below a unit
+  int2048 wh;
+  wh.a.assign(w.a.begin() + l, w.a.end());
+  int2048 rh = recip(wh);
+  int nr = (int)rh.a.size(), j0 = nr - 1 - G; // lowest column read
+  std::vector<int> xw(G + p + 1, 0);
+  std::memcpy(xw.data() + G, w.a.data(), sizeof(int) * p);
+  int cnt = p + 1 - j0;
+  std::vector<long long> c(cnt);
+  conv_mid(xw.data(), G + p + 1, rh.a.data(), nr, c.data());
+  int2048 e;
+  carry_columns(c.data(), cnt, e.a);
+  e.a.resize(cnt); // e mod BASE^(p+1), in units of BASE^j0
+  bool eneg = e.a[cnt - 1] >= BASE / 2;
+  if (eneg) {
+    int2048 mod;
+    mod.a.assign(cnt + 1, 0); mod.a[cnt] = 1;
+    e.trim();
+    e = sub_abs(mod, e);
+  }
+  e.trim();
+  int2048 corr = mulhi(rh, e, 2 * h - j0), R = rh;
+  R.shift_limbs(l);
+  if (eneg) R = add_abs(R, corr);
+  else R = sub_abs(R, corr);
+  return R;
+}
+
+// u < v * BASE^(n-m+1) by v, given R ~ BASE^(2p) / v_p for the top p limbs v_p of v.
+// The estimate from the top limbs is within a few units, so u - q * v lies within a
+// few v of zero and its low m + 1 limbs (a short product) pin it down.
+void int2048::div_block(const int2048 &u, const int2048 &v, const int2048 &R, int p, int2048 &q, int2048 &r) {
+  int m = (int)v.a.size();
+  if (u.abs_compare(v) < 0) { q = int2048(); r = u; return; }
+  int2048 ut;
+  ut.a.assign(u.a.begin() + (m - 1), u.a.end());
+  q = mulhi(ut, R, p + 1);
+  int2048 ul;
+  ul.a.assign(u.a.begin(), u.a.begin() + std::min((int)u.a.size(), m + 1));
+  ul.trim();
+  r = ul - mullo(q, v, m + 1);
+  if ((int)r.a.size() == m + 1 && r.a[m] >= BASE / 2) {
+    // wrapped: |u - q * v| < BASE^(m+1) / 2
+    int2048 mod;
+    mod.a.assign(m + 2, 0); mod.a[m + 1] = 1;
+    if (r.neg) r += mod; else r -= mod;
+  }
+  while (r.neg) { r += v; q -= int2048(1); }
+  while (r.abs_compare(v) >= 0) { r -= v; q += int2048(1); }
+}
+
+void int2048::divmod_newton(const int2048 &u, const int2048 &v, int2048 &q, int2048 &r) {
+  int n = (int)u.a.size(), m = (int)v.a.size();
+  if (n <= 2 * m) {
+    // the quotient has n - m + 1 limbs; as many of v (plus guards) are enough
+    int p = std::min(m, n - m + 3);
+    int2048 vp;
+    vp.a.assign(v.a.end() - p, v.a.end());
+    div_block(u, v, recip(vp), p, q, r);
+    return;
+  }
+  // m-limb chunks of u from the top, each appended to the remainder so far
+  int2048 R = recip(v), blk, qt;
+  q.a.assign(n, 0); q.neg = false;
+  r = int2048();
+  for (int t = (n - 1) / m; t >= 0; --t) {
+    int lo = t * m, hi = std::min(n, lo + m);
+    blk.a.assign(u.a.begin() + lo, u.a.begin() + hi);
+    if (!r.is_zero()) {
+      blk.a.resize(m, 0);
+      blk.a.insert(blk.a.end(), r.a.begin(), r.a.end());
+    }
+    blk.neg = false;
+    blk.trim();
+    div_block(blk, v, R, m, qt, r);
+    if (!qt.is_zero()) std::memcpy(q.a.data() + lo, qt.a.data(), sizeof(int) * qt.a.size());
+  }
+  q.trim();
+}
+
+// Signs are ignored: q = |u| / |v| and r = |u| mod |v|.
 void int2048::divmod_abs(const int2048 &u, const int2048 &v, int2048 &q, int2048 &r) {
   q = int2048(0); r = int2048(0);
   if (v.is_zero()) return; // undefined, guarded by tests
-  if (u.abs_compare(v) < 0) { r = u; return; }
+  if (u.abs_compare(v) < 0) { r = u; r.neg = false; return; }
+  int n = (int)u.a.size(), m = (int)v.a.size();
+  if (m == 1) {
+    q = u; q.neg = false;
+    r = int2048(div_by_int(q, v.a[0]));
+    return;
+  }
+  // scaling both by d leaves the quotient alone and the remainder times d
+  int d = BASE / (v.a.back() + 1);
+  int2048 un = mul_by_int(u, d), vn = mul_by_int(v, d);
+  if (m < DIV_NEWTON_MIN || n - m < DIV_NEWTON_MIN) divmod_knuth(un, vn, q, r);
+  else divmod_newton(un, vn, q, r);
+  div_by_int(r, d);
+}
 
-  // shift v so its size matches u (like long division by base blocks)
-  int n = (int)u.a.size();
-  int m = (int)v.a.size();
-  int k = n - m;
+// ===== radix conversion =====
+int int2048::radix_word(int base, int &k) {
+  long long w = base;
+  for (k = 1; w * base < (1LL << 31); ++k) w *= base;
+  return (int)w;
+}
+
+const std::vector<int2048> &int2048::radix_powers(int base, int t) {
+  static std::vector<int2048> cache[63];
+  std::vector<int2048> &pw = cache[base];
+  if (pw.empty()) { int k; pw.push_back(int2048(radix_word(base, k))); }
+  while ((int)pw.size() <= t) pw.push_back(mul_abs(pw.back(), pw.back()));
+  return pw;
+}
+
+int int2048::radix_levels(const int2048 &x, int base) {
+  int t = 0;
+  while (radix_powers(base, t + 1)[t + 1].abs_compare(x) <= 0) ++t;
+  return t;
+}
+
+// x by base^(k * 2^t) as divmod_abs would, reusing the power's reciprocal
+void int2048::radix_split(const int2048 &x, int base, int t, int2048 &q, int2048 &r) {
+  const int2048 &w = radix_powers(base, t)[t];
+  int n = (int)x.a.size(), m = (int)w.a.size();
+  if (m < DIV_NEWTON_MIN || n - m < DIV_NEWTON_MIN) { divmod_abs(x, w, q, r); return; }
+  static std::vector<int2048> cache[63];
+  std::vector<int2048> &rc = cache[base];
+  if ((int)rc.size() <= t) rc.resize(t + 1);
+  int d = BASE / (w.a.back() + 1);
+  int2048 vn = mul_by_int(w, d);
+  if (rc[t].is_zero()) rc[t] = recip(vn);
+  div_block(mul_by_int(x, d), vn, rc[t], m, q, r);
+  div_by_int(r, d);
+}
+
+// exactly k * 2^(t+1) digits of |x| < base^(k * 2^(t+1)), leading zeros included
+void int2048::radix_to_digits(const int2048 &x, int base, int t, unsigned char *out) {
+  int k, w = radix_word(base, k);
+  if (t < RADIX_LEAF) {
+    int2048 y = x;
+    for (int j = (2 << t) - 1; j >= 0; --j) {
+      int r = div_by_int(y, w);
+      for (int i = k - 1; i >= 0; --i) { out[j * k + i] = (unsigned char)(r % base); r /= base; }
+    }
+    return;
+  }
+  int2048 q, r;
+  radix_split(x, base, t, q, r);
+  radix_to_digits(q, base, t - 1, out);
+  radix_to_digits(r, base, t - 1, out + ((size_t)k << t));
+}
+
+int2048 int2048::radix_from_digits(const unsigned char *d, size_t n, int base) {
+  int k;
+  radix_word(base, k);
+  if (n <= ((size_t)k << (RADIX_LEAF + 1))) {
+    // word by word: x = x * base^len + chunk
+    int2048 x;
+    for (size_t i = 0; i < n; ) {
+      size_t len = i ? k : (n - 1) % k + 1;
+      long long m = 1, carry = 0;
+      for (size_t j = 0; j < len; ++j) { carry = carry * base + d[i + j]; m *= base; }
+      for (int &v : x.a) { long long t = v * m + carry; v = (int)(t % BASE); carry = t / BASE; }
+      for (; carry; carry /= BASE) x.a.push_back((int)(carry % BASE));
+      i += len;
+    }
+    x.trim();
+    return x;
+  }
+  int t = 0;
+  while (((size_t)k << (t + 1)) < n) ++t;
+  size_t low = (size_t)k << t;
+  int2048 hi = radix_from_digits(d, n - low, base);
+  return add_abs(mul_abs(hi, radix_powers(base, t)[t]), radix_from_digits(d + n - low, low, base));
+}
+
+char int2048::radix_char(int v, int base) {
+  if (v < 10) return char('0' + v);
+  if (base <= 36) return char('a' + v - 10);
+  return v < 36 ? char('A' + v - 10) : char('a' + v - 36);
+}
+
+int int2048::radix_digit(char c, int base) {
+  int v = c >= '0' && c <= '9' ? c - '0'
+        : c >= 'A' && c <= 'Z' ? c - 'A' + 10
+        : c >= 'a' && c <= 'z' ? c - 'a' + (base <= 36 ? 10 : 36) : base;
+  return v < base ? v : -1;
+}
+
+// ===== powers of the base and of ten =====
+bool int2048::drop_limbs(size_t d) {
+  if (d > a.size()) d = a.size();
+  bool lost = false;
+  for (size_t i = 0; i < d && !lost; ++i) lost = a[i] != 0;
+  a.erase(a.begin(), a.begin() + d);
+  return lost;
+}
+
+int2048 &int2048::shift_limbs(long long k) {
+  touch();
+  if (is_zero() || k == 0) return *this;
+  if (k > 0) { a.insert(a.begin(), (size_t)k, 0); return *this; }
+  bool n = neg, lost = drop_limbs((size_t)-k);
+  trim();
+  if (n && lost) *this -= int2048(1);
+  return *this;
+}
+
+int2048 &int2048::mul_pow10(unsigned long long k) {
+  touch();
+  if (is_zero()) return *this;
+  if (k % 4) {
+    int m = k % 4 == 1 ? 10 : k % 4 == 2 ? 100 : 1000, c = 0;
+    for (int &d : a) {
+      int cur = d * m + c;
+      c = cur / BASE; d = cur - c * BASE;
+    }
+    if (c) a.push_back(c);
+  }
+  if (k >= 4) a.insert(a.begin(), (size_t)(k / 4), 0);
+  return *this;
+}
+
+int2048 &int2048::div_pow10(unsigned long long k) {
+  touch();
+  if (is_zero()) return *this;
+  bool n = neg, lost = drop_limbs(k / 4 < a.size() ? (size_t)(k / 4) : a.size());
+  if (k % 4 && !a.empty()) lost |= div_by_int(*this, k % 4 == 1 ? 10 : k % 4 == 2 ? 100 : 1000) != 0;
+  trim();
+  if (n && lost) *this -= int2048(1);
+  return *this;
+}
+
+// ===== powers =====
+int2048 int2048::pow_abs(const int2048 &y, unsigned long long k) {
+  int bits = 64 - __builtin_clzll(k);
+  if (y.a.size() == 1) {
+    int2048 r(y.a[0]);
+    for (int i = bits - 2; i >= 0; --i) {
+      r = mul_abs(r, r);
+      if (k >> i & 1) r = mul_by_int(r, y.a[0]);
+    }
+    return r;
+  }
+  // odd[i] = y^(2i+1); windows of up to w bits, each ending in a one
+  int w = bits < 8 ? 1 : bits < 24 ? 3 : bits < 80 ? 4 : 5;
+  std::vector<int2048> odd(1 << (w - 1));
+  odd[0] = y;
+  if (w > 1) {
+    int2048 y2 = mul_abs(y, y);
+    for (size_t i = 1; i < odd.size(); ++i) odd[i] = mul_abs(odd[i - 1], y2);
+  }
+  int2048 r;
+  bool started = false;
+  for (int i = bits - 1; i >= 0; ) {
+    if (!(k >> i & 1)) { r = mul_abs(r, r); --i; continue; }
+    int j = std::max(i - w + 1, 0);
+    while (!(k >> j & 1)) ++j;
+    if (started) {
+      for (int t = j; t <= i; ++t) r = mul_abs(r, r);
+      r = mul_abs(r, odd[(k >> j & ((2ULL << (i - j)) - 1)) >> 1]);
+    } else {
+      r = odd[(k >> j & ((2ULL << (i - j)) - 1)) >> 1];
+      started = true;
+    }
+    i = j - 1;
+  }
+  return r;
+}
+
+int2048 pow(const int2048 &x, unsigned long long k) {
+  if (k == 0) return int2048(1);
+  if (x.is_zero()) return x;
+  // x = y * 10^z with y free of trailing zeros, so x^k = y^k * 10^(z k)
+  size_t zl = 0;
+  while (x.a[zl] == 0) ++zl;
+  int zd = 0, m = 1;
+  for (int v = x.a[zl]; v % 10 == 0; v /= 10) { ++zd; m *= 10; }
+  int2048 y;
+  y.a.assign(x.a.begin() + zl, x.a.end());
+  if (zd) int2048::div_by_int(y, m);
+  int2048 r = int2048::pow_abs(y, k);
+  r.mul_pow10((4 * zl + zd) * k);
+  r.neg = x.neg && (k & 1);
+  return r;
+}
+
+// ===== modular powers =====
+struct int2048::mod_ctx {
+  int2048 m, mi, vn, R; // mi = -1/m mod BASE^n; vn = m * d and R ~ BASE^(2n) / vn
+  int n, d = 1;
+  bool mont;
+
+  explicit mod_ctx(const int2048 &mod) : m(mod), n((int)mod.a.size()) {
+    m.neg = false;
+    mont = n > 1 && m.a[0] % 2 && m.a[0] % 5;
+    if (mont) {
+      // Newton lifts y = 1/m from mod 10 to mod BASE^n, doubling the digits each step
+      int m0 = m.a[0], y = m0 % 10 == 3 ? 7 : m0 % 10 == 7 ? 3 : m0 % 10;
+      for (int i = 0; i < 2; ++i) y = (int)((long long)y * ((2 - (long long)m0 * y) % BASE + BASE) % BASE);
+      int2048 inv(y), two;
+      for (int k = 1; k < n; ) {
+        k = std::min(2 * k, n);
+        two.a.assign(k + 1, 0); two.a[k] = 1; two.a[0] = 2; // BASE^k + 2
+        inv = mullo(inv, sub_abs(two, mullo(m, inv, k)), k);
+      }
+      two.a.assign(n + 1, 0); two.a[n] = 1;
+      mi = sub_abs(two, inv);
+    } else if (n > 1) {
+      d = BASE / (m.a.back() + 1);
+      vn = mul_by_int(m, d);
+      R = recip(vn);
+    }
+  }
+
+  // T * BASE^-n mod m for T < m * BASE^n: the low n limbs of T + (T mi mod BASE^n) m
+  // vanish, and their carry is 1 unless T's own low limbs are zero
+  int2048 redc(const int2048 &T) const {
+    int2048 lo, hi;
+    lo.a.assign(T.a.begin(), T.a.begin() + std::min((int)T.a.size(), n));
+    lo.trim();
+    if ((int)T.a.size() > n) hi.a.assign(T.a.begin() + n, T.a.end());
+    int2048 u = add_abs(hi, mulhi(mullo(lo, mi, n), m, n));
+    if (!lo.is_zero()) u = add_abs(u, int2048(1));
+    if (u.abs_compare(m) >= 0) u = sub_abs(u, m);
+    return u;
+  }
+
+  int2048 mul(const int2048 &x, const int2048 &y) const {
+    int2048 T = mul_abs(x, y);
+    if (mont) return redc(T);
+    if (T.abs_compare(m) < 0) return T;
+    if (n == 1) return int2048(div_by_int(T, m.a[0]));
+    int2048 q, r;
+    div_block(mul_by_int(T, d), vn, R, n, q, r);
+    div_by_int(r, d);
+    return r;
+  }
+
+  int2048 to(const int2048 &x) const { // x < m into the working form
+    if (!mont || x.is_zero()) return x;
+    int2048 t = x, q, r;
+    t.shift_limbs(n);
+    divmod_abs(t, m, q, r);
+    return r;
+  }
+  int2048 from(const int2048 &x) const { return mont ? redc(x) : x; }
+};
+
+int2048 powmod(const int2048 &b, const int2048 &e, const int2048 &mod) {
+  if (mod.is_zero()) return int2048();
+  if (e.neg) {
+    int2048 inv = modinv(b, mod);
+    return inv.is_zero() ? inv : powmod(inv, -e, mod);
+  }
+  int2048::mod_ctx c(mod);
+  int2048 x = b % c.m, r;
+  if (e.is_zero()) r = int2048(1) % c.m;
+  else {
+    // the bits of e, most significant first
+    int t = int2048::radix_levels(e, 2), k;
+    int2048::radix_word(2, k);
+    std::vector<unsigned char> bits((size_t)k << (t + 1));
+    int2048::radix_to_digits(e, 2, t, bits.data());
+    int i = 0, nb = (int)bits.size();
+    while (!bits[i]) ++i;
+    int len = nb - i, w = len < 8 ? 1 : len < 24 ? 3 : len < 80 ? 4 : len < 240 ? 5 : 6;
+    std::vector<int2048> odd(1 << (w - 1)); // odd[j] = x^(2j+1), working form
+    odd[0] = c.to(x);
+    if (w > 1) {
+      int2048 x2 = c.mul(odd[0], odd[0]);
+      for (size_t j = 1; j < odd.size(); ++j) odd[j] = c.mul(odd[j - 1], x2);
+    }
+    bool started = false;
+    while (i < nb) {
+      if (!bits[i]) { r = c.mul(r, r); ++i; continue; }
+      // the longest window of up to w bits from i that ends in a one
+      int j = std::min(i + w, nb) - 1, v = 0;
+      while (!bits[j]) --j;
+      for (int s = i; s <= j; ++s) v = 2 * v + bits[s];
+      if (started) {
+        for (int s = i; s <= j; ++s) r = c.mul(r, r);
+        r = c.mul(r, odd[v >> 1]);
+      } else {
+        r = odd[v >> 1];
+        started = true;
+      }
+      i = j + 1;
+    }
+    r = c.from(r);
+  }
+  if (mod.neg && !r.is_zero()) r = int2048::sub_abs(c.m, r), r.neg = true;
+  return r;
+}
+
+// ===== roots =====
+// m of even length with top limb >= BASE / 4: s = floor(sqrt(m)), r = m - s^2.
+// With m = a3 b^3 + a2 b^2 + a1 b + a0, b = BASE^l: s' from a3 b + a2, then
+// q = (r' b + a1) / 2s' gives s = s' b + q, off by at most one.
+void int2048::sqrtrem_norm(const int2048 &m, int2048 &s, int2048 &r) {
+  int n = (int)m.a.size();
+  if (n <= 4) {
+    long long v = 0;
+    for (int i = n - 1; i >= 0; --i) v = v * BASE + m.a[i];
+    long long t = (long long)std::sqrt((double)v);
+    while (t * t > v) --t;
+    while ((t + 1) * (t + 1) <= v) ++t;
+    s = int2048(t); r = int2048(v - t * t);
+    return;
+  }
+  int l = (n - 1) / 4;
+  auto part = [&](int from, int to) {
+    int2048 t;
+    t.a.assign(m.a.begin() + from, m.a.begin() + to);
+    t.trim();
+    return t;
+  };
+  int2048 s1, r1, q, u;
+  sqrtrem_norm(part(2 * l, n), s1, r1);
+  int2048 num = part(l, 2 * l);
+  r1.shift_limbs(l);
+  num += r1;
+  divmod_abs(num, mul_by_int(s1, 2), q, u);
+  s = s1;
+  s.shift_limbs(l);
+  s += q;
+  u.shift_limbs(l);
+  r = u + part(0, l) - mul_abs(q, q);
+  if (r.neg) {
+    r += mul_by_int(s, 2) - int2048(1);
+    s -= int2048(1);
+  }
+}
+
+int2048 isqrt(const int2048 &x, int2048 &rem) {
+  if (x.is_zero() || x.neg) { rem = int2048(); return int2048(); }
+  // scale by C^2 to an even length with a top limb of at least BASE / 4:
+  // a limb (C = 100) for odd lengths, then c^2 for a small top
+  int2048 m = x;
+  m.neg = false;
+  int C = 1;
+  if (m.a.size() % 2) { m.shift_limbs(1); C = 100; }
+  int c = 1;
+  while (c * c * m.a.back() < int2048::BASE / 4) ++c;
+  if (c > 1) m = int2048::mul_by_int(m, c * c);
+  int2048 s, r;
+  int2048::sqrtrem_norm(m, s, r);
+  if (C * c > 1) {
+    int2048::div_by_int(s, C * c);
+    r = x - int2048::mul_abs(s, s);
+  }
+  rem = r;
+  return s;
+}
+
+int2048 isqrt(const int2048 &x) {
+  int2048 r;
+  return isqrt(x, r);
+}
+
+// floor(x^(1/n)) for x > 0, n >= 3
+int2048 int2048::root_abs(const int2048 &x, unsigned long n) {
+  int N = (int)x.a.size(), L = (int)((N - 1) / n + 1); // the root has at most L limbs
+  if (n >= 14ul * N) return int2048(1); // x < BASE^N < 2^n
+  int2048 y;
+  if (L <= 3) {
+    // from a double of the top four limbs, nudged up past their truncation
+    double top = 0;
+    int j = N - 1;
+    for (int i = 0; i < 4 && j >= 0; ++i, --j) top = top * BASE + x.a[j];
+    double lg = (std::log(top) + (j + 1) * std::log((double)BASE)) / n;
+    y = int2048((long long)(std::exp(lg) * (1 + 1e-7)) + 2);
+  } else {
+    // (root of the top + 1) * BASE^h is above the root and right to about L - h limbs
+    int h = L / 2;
+    int2048 t;
+    t.a.assign(x.a.begin() + n * h, x.a.end());
+    y = root_abs(t, n) + int2048(1);
+    y.shift_limbs(h);
+  }
+  // Newton from above: y' = ((n - 1) y + x / y^(n-1)) / n decreases to the root
+  for (int2048 z, q, r;;) {
+    divmod_abs(x, pow(y, n - 1), q, r);
+    z = mul_by_int(y, (int)(n - 1)) + q;
+    div_by_int(z, (int)n);
+    if (z.abs_compare(y) >= 0) return y;
+    y = z;
+  }
+}
+
+int2048 iroot(const int2048 &x, unsigned long n, int2048 &rem) {
+  if (n == 0 || (x.neg && n % 2 == 0)) { rem = int2048(); return int2048(); }
+  if (n == 1) { rem = int2048(); return x; }
+  int2048 ax = x, y;
+  ax.neg = false;
+  if (n == 2) y = isqrt(ax);
+  else if (!ax.is_zero()) y = int2048::root_abs(ax, n);
+  if (x.neg) y = -y;
+  rem = x - pow(y, n);
+  return y;
+}
+
+int2048 iroot(const int2048 &x, unsigned long n) {
+  int2048 r;
+  return iroot(x, n, r);
+}
+
+// ===== gcd =====
+struct int2048::gcd_matrix {
+  int2048 m[2][2];
+  gcd_matrix() { m[0][0] = m[1][1] = int2048(1); }
+  // *this = [[p, q], [r, s]] * *this
+  void left(const int2048 &p, const int2048 &q, const int2048 &r, const int2048 &s) {
+    for (int j = 0; j < 2; ++j) {
+      int2048 t = p * m[0][j] + q * m[1][j];
+      m[1][j] = r * m[0][j] + s * m[1][j];
+      m[0][j] = t;
+    }
+  }
+  void left(const gcd_matrix &N) { left(N.m[0][0], N.m[0][1], N.m[1][0], N.m[1][1]); }
+  // the same for word-sized p..s; Euclid's cofactors alternate in sign, so each
+  // entry is usually a sum of two magnitudes in one pass
+  void left(long long p, long long q, long long r, long long s) {
+    for (int j = 0; j < 2; ++j) {
+      int2048 t = comb(p, m[0][j], q, m[1][j]);
+      m[1][j] = comb(r, m[0][j], s, m[1][j]);
+      m[0][j] = t;
+    }
+  }
+  static int2048 comb(long long p, const int2048 &x, long long q, const int2048 &y) {
+    bool sx = (p < 0) != x.neg, sy = (q < 0) != y.neg;
+    if (x.is_zero() || p == 0) sx = sy;
+    if (y.is_zero() || q == 0) sy = sx;
+    if (sx != sy) return int2048(p) * x + int2048(q) * y;
+    int2048 t = lin_comb(x, p < 0 ? -p : p, y, q < 0 ? -q : q);
+    t.neg = sx && !t.is_zero();
+    return t;
+  }
+};
+
+int2048 int2048::lin_comb(const int2048 &x, long long p, const int2048 &y, long long q) {
+  int2048 r;
+  size_t nx = x.a.size(), ny = y.a.size(), n = std::max(nx, ny);
+  const int *xa = x.a.data(), *ya = y.a.data();
+  r.a.resize(n);
+  long long carry = 0;
+  for (size_t i = 0; i < n; ++i) {
+    long long cur = carry;
+    if (i < nx) cur += p * xa[i];
+    if (i < ny) cur += q * ya[i];
+    carry = cur / BASE;
+    long long d = cur - carry * BASE;
+    if (d < 0) { d += BASE; --carry; }
+    r.a[i] = (int)d;
+  }
+  for (; carry > 0; carry /= BASE) r.a.push_back((int)(carry % BASE));
+  r.trim();
+  return r;
+}
+
+// (a, b) -> (b, a mod b)
+void int2048::gcd_div_step(int2048 &a, int2048 &b, gcd_matrix *M) {
+  int2048 q, r;
+  divmod_abs(a, b, q, r);
+  a.a.swap(b.a);
+  b.a.swap(r.a);
+  if (M) M->left(int2048(0), int2048(1), int2048(1), -q);
+}
+
+// Knuth's algorithm L: Euclid on the top 4 limbs while the quotients provably match
+// those of a and b, then one linear combination of the full numbers. Falls back to
+// a division step when the sizes differ or no quotient is certain.
+void int2048::gcd_lehmer(int2048 &a, int2048 &b, gcd_matrix *M) {
+  int n = (int)a.a.size();
+  if (n <= 4 || (int)b.a.size() < n - 1) { gcd_div_step(a, b, M); return; }
+  long long ah = 0, bh = 0;
+  for (int i = n - 1; i >= n - 4; --i) {
+    ah = ah * BASE + a.a[i];
+    bh = bh * BASE + (i < (int)b.a.size() ? b.a[i] : 0);
+  }
+  long long A = 1, B = 0, C = 0, D = 1;
+  const long long LIM = 1000000000; // keeps the combinations' columns in range
+  while (bh + C != 0 && bh + D != 0) {
+    long long q = (ah + A) / (bh + C);
+    if (q != (ah + B) / (bh + D)) break;
+    long long t = A - q * C; A = C; C = t;
+    t = B - q * D; B = D; D = t;
+    t = ah - q * bh; ah = bh; bh = t;
+    if (std::max(std::max(A, -A), std::max(C, -C)) > LIM || std::max(std::max(B, -B), std::max(D, -D)) > LIM) break;
+  }
+  if (B == 0) { gcd_div_step(a, b, M); return; }
+  int2048 na = lin_comb(a, A, b, B);
+  b = lin_comb(a, C, b, D);
+  a.a.swap(na.a);
+  if (M) M->left(A, B, C, D);
+}
+
+// (a, b) = M (a, b), rows negated or swapped as needed for a >= b >= 0; T picks up M
+void int2048::gcd_apply(gcd_matrix &M, int2048 &a, int2048 &b, gcd_matrix *T) {
+  int2048 na = M.m[0][0] * a + M.m[0][1] * b, nb = M.m[1][0] * a + M.m[1][1] * b;
+  for (int i = 0; i < 2; ++i) {
+    int2048 &v = i ? nb : na;
+    if (v.neg) { v.neg = false; M.m[i][0] = -M.m[i][0]; M.m[i][1] = -M.m[i][1]; }
+  }
+  if (na.abs_compare(nb) < 0) {
+    std::swap(na.a, nb.a);
+    for (int j = 0; j < 2; ++j) std::swap(M.m[0][j].a, M.m[1][j].a), std::swap(M.m[0][j].neg, M.m[1][j].neg);
+  }
+  a.a.swap(na.a);
+  b.a.swap(nb.a);
+  if (T) T->left(M);
+}
+
+// M taking a >= b of n limbs to about n / 2 + 1 limbs. The quotients of the top
+// halves are (nearly all) those of the full numbers, so M1 from them leaves about
+// 3n/4 limbs; after one division the top of those gives M2 for the rest.
+void int2048::hgcd(const int2048 &a0, const int2048 &b0, gcd_matrix &M) {
+  M = gcd_matrix();
+  int2048 a = a0, b = b0;
+  int n = (int)a.a.size(), s = n / 2 + 1;
+  if ((int)b.a.size() <= s) return;
+  if (n > HGCD_MIN) {
+    int p = n / 2;
+    int2048 a1, b1;
+    a1.a.assign(a.a.begin() + p, a.a.end());
+    b1.a.assign(b.a.begin() + p, b.a.end());
+    b1.trim();
+    gcd_matrix M1;
+    hgcd(a1, b1, M1);
+    gcd_apply(M1, a, b, &M);
+    if ((int)b.a.size() > s) gcd_div_step(a, b, &M);
+    int m = (int)a.a.size(), p2 = 2 * s - m;
+    if ((int)b.a.size() > s && p2 >= 0 && p2 < (int)b.a.size()) {
+      a1.a.assign(a.a.begin() + p2, a.a.end());
+      b1.a.assign(b.a.begin() + p2, b.a.end());
+      b1.trim();
+      hgcd(a1, b1, M1);
+      gcd_apply(M1, a, b, &M);
+    }
+  }
+  // the rest exactly: Lehmer batches (about 2 limbs each) well above s, then divisions
+  while ((int)b.a.size() > s) {
+    if ((int)b.a.size() > s + 2) gcd_lehmer(a, b, &M);
+    else gcd_div_step(a, b, &M);
+  }
+}
+
+// a = gcd(a, b), b = 0; T, if given, collects the transform
+void int2048::gcd_core(int2048 &a, int2048 &b, gcd_matrix *T) {
+  while (!b.is_zero()) {
+    int n = (int)a.a.size();
+    if (n > HGCD_MIN && (int)b.a.size() > n / 2 + 1) {
+      gcd_matrix M;
+      hgcd(a, b, M);
+      gcd_apply(M, a, b, T);
+      if (!b.is_zero()) gcd_div_step(a, b, T);
+    } else {
+      gcd_lehmer(a, b, T);
+    }
+  }
+}
+
+int2048 gcd(const int2048 &x, const int2048 &y) {
+  int2048 a = x, b = y;
+  a.neg = b.neg = false;
+  if (a.abs_compare(b) < 0) a.a.swap(b.a);
+  int2048::gcd_core(a, b, nullptr);
+  return a;
+}
+
+int2048 lcm(const int2048 &x, const int2048 &y) {
+  if (x.is_zero() || y.is_zero()) return int2048();
+  int2048 r = x / gcd(x, y) * y;
+  r.neg = false;
+  return r;
+}
+
+int2048 gcdext(const int2048 &x, const int2048 &y, int2048 &u, int2048 &v) {
+  int2048 a = x, b = y;
+  a.neg = b.neg = false;
+  if (b.is_zero()) { u = int2048(x.is_zero() ? 0 : x.neg ? -1 : 1); v = int2048(); return a; }
+  bool swapped = a.abs_compare(b) < 0;
+  if (swapped) a.a.swap(b.a);
+  int2048::gcd_matrix T;
+  int2048::gcd_core(a, b, &T);
+  // g = T00 |big| + T01 |small|; the cofactor of |x| is moved into (-|y|/2g, |y|/2g]
+  // and the one of |y| follows from it
+  int2048 cx = swapped ? T.m[0][1] : T.m[0][0], ax = x, ay = y;
+  ax.neg = ay.neg = false;
+  int2048 yg = ay / a;
+  cx %= yg;
+  if (cx + cx > yg) cx -= yg;
+  v = (a - ax * cx) / ay;
+  u = x.neg ? -cx : cx;
+  if (y.neg) v = -v;
+  return a;
+}
+
+int2048 modinv(const int2048 &x, const int2048 &m) {
+  int2048 u, v, mm = m;
+  mm.neg = false;
+  if (gcdext(x % mm, mm, u, v) != int2048(1)) return int2048();
+  return u % mm;
+}
+
+// ===== combinatorics =====
+void int2048::sieve(unsigned long n, std::vector<int> &primes) {
+  primes.clear();
+  if (n < 2) return;
+  primes.push_back(2);
+  std::vector<char> comp(n / 2 + 1, 0); // comp[i] for 2i + 1
+  for (unsigned long i = 1; 2 * i + 1 <= n; ++i) {
+    if (comp[i]) continue;
+    unsigned long p = 2 * i + 1;
+    primes.push_back((int)p);
+    for (unsigned long j = p * p / 2; j <= n / 2; j += p) comp[j] = 1;
+  }
+}
+
+unsigned long int2048::legendre(unsigned long n, unsigned long p) {
+  unsigned long e = 0;
+  for (; n >= p; n /= p) e += n / p;
+  return e;
+}
+
+int2048 int2048::prod_words(const int *w, size_t n) {
+  if (n <= 16) {
+    int2048 r(1);
+    for (size_t i = 0; i < n; ++i) r = mul_by_int(r, w[i]);
+    return r;
+  }
+  return mul_abs(prod_words(w, n / 2), prod_words(w + n / 2, n - n / 2));
+}
+
+int2048 int2048::prod_tree(std::vector<int2048> &v) {
+  if (v.empty()) return int2048(1);
+  // always multiply the two shortest, from a min-heap of indices by limb count
+  std::vector<size_t> h(v.size());
+  size_t m = h.size();
+  for (size_t i = 0; i < m; ++i) h[i] = i;
+  auto key = [&](size_t i) { return v[h[i]].a.size(); };
+  auto down = [&](size_t i) {
+    for (size_t c; (c = 2 * i + 1) < m; i = c) {
+      if (c + 1 < m && key(c + 1) < key(c)) ++c;
+      if (key(i) <= key(c)) break;
+      std::swap(h[i], h[c]);
+    }
+  };
+  for (size_t i = m / 2; i-- > 0;) down(i);
+  while (m > 1) {
+    size_t x = h[0];
+    h[0] = h[--m];
+    down(0);
+    v[x] = mul_abs(v[x], v[h[0]]);
+    std::vector<int>().swap(v[h[0]].a); // done with it
+    h[0] = x;
+    down(0);
+  }
+  return v[h[0]];
+}
+
+int2048 int2048::prime_power_product(const std::vector<int> &p, const std::vector<unsigned long> &e) {
+  unsigned long top = 0;
+  for (size_t i = 0; i < p.size(); ++i) top |= e[i];
+  int2048 r(1);
+  std::vector<int> w;
+  for (int k = top ? 63 - __builtin_clzll(top) : -1; k >= 0; --k) {
+    // the primes with bit k in their exponent, packed into words below 2^31
+    w.clear();
+    long long cur = 1;
+    for (size_t i = 0; i < p.size(); ++i) {
+      if (!(e[i] >> k & 1)) continue;
+      if (cur * p[i] > 0x7fffffff) { w.push_back((int)cur); cur = 1; }
+      cur *= p[i];
+    }
+    if (cur > 1) w.push_back((int)cur);
+    r = mul_abs(r, r);
+    if (!w.empty()) r = mul_abs(r, prod_words(w.data(), w.size()));
+  }
+  return r;
+}
 
-  int2048 vshift = v;
-  if (k > 0) vshift.a.insert(vshift.a.begin(), k, 0);
+int2048 factorial(unsigned long n) {
+  std::vector<int> p;
+  int2048::sieve(n, p);
+  std::vector<unsigned long> e(p.size());
+  for (size_t i = 0; i < p.size(); ++i) e[i] = int2048::legendre(n, p[i]);
+  return int2048::prime_power_product(p, e);
+}
 
-  int2048 rem = u;
-  q.a.assign(k + 1, 0);
+int2048 double_factorial(unsigned long n) {
+  // n = 2m: 2^m m!; n = 2m + 1: n! / (2^m m!)
+  unsigned long m = n / 2;
+  std::vector<int> p;
+  int2048::sieve(n % 2 ? n : m + 1, p); // m + 1 >= 2 once m > 0
+  std::vector<unsigned long> e(p.size());
+  for (size_t i = 0; i < p.size(); ++i) {
+    unsigned long lm = int2048::legendre(m, p[i]) + (p[i] == 2 ? m : 0);
+    e[i] = n % 2 ? int2048::legendre(n, p[i]) - lm : lm;
+  }
+  return int2048::prime_power_product(p, e);
+}
 
-  for (int pos = k; pos >= 0; --pos) {
-    // binary search digit in [0, BASE-1]
-    int low = 0, high = BASE - 1, best = 0;
-    while (low <= high) {
-      int mid = (low + high) >> 1;
-      int2048 t = mul_by_int(vshift, mid);
-      int cmp = t.abs_compare(rem);
-      if (cmp <= 0) { best = mid; low = mid + 1; }
-      else high = mid - 1;
+int2048 binomial(unsigned long n, unsigned long k) {
+  if (k > n) return int2048();
+  if (k > n - k) k = n - k;
+  if (k < n / 32) {
+    // small k: a sieve to n would dominate, so take n (n-1) ... (n-k+1) / k!
+    // limbs straight from the unsigned value: n - i can be past LLONG_MAX
+    std::vector<int2048> v(k);
+    for (unsigned long i = 0; i < k; ++i)
+      for (unsigned long f = n - i; f; f /= int2048::BASE) v[i].a.push_back((int)(f % int2048::BASE));
+    int2048 q, r;
+    int2048::divmod_abs(int2048::prod_tree(v), factorial(k), q, r);
+    return q;
+  }
+  // the exponent of p is the count of carries adding k and n - k in base p
+  std::vector<int> p;
+  int2048::sieve(n, p);
+  std::vector<unsigned long> e(p.size());
+  for (size_t i = 0; i < p.size(); ++i)
+    e[i] = int2048::legendre(n, p[i]) - int2048::legendre(k, p[i]) - int2048::legendre(n - k, p[i]);
+  return int2048::prime_power_product(p, e);
+}
+
+int2048 primorial(unsigned long n) {
+  std::vector<int> p;
+  int2048::sieve(n, p);
+  std::vector<unsigned long> e(p.size(), 1);
+  return int2048::prime_power_product(p, e);
+}
+
+int2048 int2048::prod_signed(std::vector<int2048> &v) {
+  bool neg = false;
+  for (const int2048 &x : v) {
+    if (x.is_zero()) return int2048();
+    neg ^= x.neg;
+  }
+  int2048 r = prod_tree(v);
+  r.neg = neg;
+  return r;
+}
+
+int2048 product(const std::vector<int2048> &v) { return product(v.begin(), v.end()); }
+
+// ===== fused multiply-add =====
+void int2048::addmul_abs(int2048 &acc, const int2048 &x, const int2048 &y, bool sub) {
+  if (x.is_zero() || y.is_zero()) return;
+  if (&acc == &x || &acc == &y) {
+    int2048 t = acc;
+    addmul_abs(acc, &acc == &x ? t : x, &acc == &y ? t : y, sub);
+    return;
+  }
+  bool pneg = x.neg ^ y.neg ^ sub;
+  if (acc.is_zero()) acc.neg = pneg;
+  bool down = pneg != acc.neg; // |acc| -= |x y|
+  // small operands go row by row into the limbs; otherwise the product is one row
+  int2048 p;
+  const int2048 *u = &x, *v = &y;
+  if (u->a.size() > v->a.size()) std::swap(u, v);
+  if ((int)u->a.size() >= KARA_MIN) { p = mul_abs(x, y); u = nullptr; v = &p; }
+  int nu = u ? (int)u->a.size() : 1, nv = (int)v->a.size();
+  int n = (int)std::max(acc.a.size(), (size_t)(nu + nv)) + 1;
+  acc.a.resize(n, 0);
+  int *A = acc.a.data();
+  const int *w = v->a.data();
+  // the top limb takes what carries reach it unnormalized, so a negative one means
+  // |x y| > |acc|
+  for (int i = 0; i < nu; ++i) {
+    long long m = u ? u->a[i] : 1, c = 0;
+    if (!m) continue;
+    int k = i;
+    if (!down) {
+      for (int j = 0; j < nv; ++j, ++k) {
+        long long cur = A[k] + m * w[j] + c;
+        c = cur / BASE; A[k] = (int)(cur - c * BASE);
+      }
+      for (; c && k < n - 1; ++k) {
+        long long cur = A[k] + c;
+        c = cur / BASE; A[k] = (int)(cur - c * BASE);
+      }
+    } else {
+      for (int j = 0; j < nv; ++j, ++k) {
+        long long cur = A[k] - m * w[j] + c;
+        c = cur / BASE; cur -= c * BASE;
+        if (cur < 0) { cur += BASE; --c; }
+        A[k] = (int)cur;
+      }
+      for (; c && k < n - 1; ++k) {
+        long long cur = A[k] + c;
+        c = cur / BASE; cur -= c * BASE;
+        if (cur < 0) { cur += BASE; --c; }
+        A[k] = (int)cur;
+      }
     }
-    if (best) {
-      int2048 t = mul_by_int(vshift, best);
-      rem = sub_abs(rem, t);
+    A[n - 1] += (int)c;
+  }
+  if (A[n - 1] < 0) {
+    // below zero: negate the limbs and carry again
+    long long c = 0;
+    for (int k = 0; k < n; ++k) {
+      long long cur = c - A[k];
+      c = cur / BASE; cur -= c * BASE;
+      if (cur < 0) { cur += BASE; --c; }
+      A[k] = (int)cur;
     }
-    q.a[pos] = best;
-    // shift vshift down by one base block
-    if (!vshift.a.empty()) vshift.a.erase(vshift.a.begin());
-    vshift.trim();
+    acc.neg = !acc.neg;
   }
-  q.trim(); r = rem; r.neg = false;
+  acc.trim();
+  acc.touch();
+}
+
+int2048 &addmul(int2048 &acc, const int2048 &x, const int2048 &y) {
+  int2048::addmul_abs(acc, x, y, false);
+  return acc;
+}
+
+int2048 &submul(int2048 &acc, const int2048 &x, const int2048 &y) {
+  int2048::addmul_abs(acc, x, y, true);
+  return acc;
+}
+
+int2048 dot(const std::vector<int2048> &x, const std::vector<int2048> &y) {
+  size_t n = std::min(x.size(), y.size());
+  return dot(x.begin(), x.begin() + n, y.begin());
 }
 
 // ===== operators (Integer2) =====
@@ -212,7 +1829,7 @@ int2048 int2048::operator-() const {
   int2048 r(*this); if (!r.is_zero()) r.neg = !r.neg; return r;
 }
 
-int2048 &int2048::operator=(const int2048 &o) { a = o.a; neg = o.neg; return *this; }
+int2048 &int2048::operator=(const int2048 &o) { a = o.a; neg = o.neg; touch(); return *this; }
 
 int2048 &int2048::operator+=(const int2048 &b) { return add(b); }
 int2048 operator+(int2048 a, const int2048 &b) { return add(a, b); }
@@ -221,66 +1838,106 @@ int2048 &int2048::operator-=(const int2048 &b) { return minus(b); }
 int2048 operator-(int2048 a, const int2048 &b) { return minus(a, b); }
 
 int2048 &int2048::operator*=(const int2048 &b) {
+  // the kernels only read the limbs, so no sign-stripped copies are needed
   bool sign = (neg != b.neg);
-  int2048 x = *this; x.neg = false;
-  int2048 y = b; y.neg = false;
-  int2048 r = mul_fft(x, y);
-  r.neg = sign && !r.is_zero();
-  *this = r; return *this;
+  int2048 r = mul_abs(*this, b);
+  a.swap(r.a); touch();
+  neg = sign && !is_zero(); return *this;
 }
 int2048 operator*(int2048 a, const int2048 &b) { a *= b; return a; }
 
 int2048 &int2048::operator/=(const int2048 &b) {
+  // floor towards -inf: a negative quotient with a remainder goes one further down
   bool neg_res = (neg != b.neg);
-  int2048 qa, ra;
-  int2048 A = *this; A.neg = false; int2048 B = b; B.neg = false;
-  divmod_abs(A, B, qa, ra);
-  if (neg_res && !ra.is_zero()) {
-    // floor towards -inf: if negative and has remainder, subtract 1
-    qa = add_abs(qa, int2048(1));
-    qa.neg = true;
-  } else {
-    qa.neg = neg_res && !qa.is_zero();
-  }
-  *this = qa; return *this;
+  int2048 q, r;
+  divmod_abs(*this, b, q, r);
+  if (neg_res && !r.is_zero()) q = add_abs(q, int2048(1));
+  a.swap(q.a); touch();
+  neg = neg_res && !is_zero(); return *this;
 }
 int2048 operator/(int2048 a, const int2048 &b) { a /= b; return a; }
 
 int2048 &int2048::operator%=(const int2048 &b) {
-  // r = x - (x / y) * y (with floor division)
-  int2048 q = (*this) / b;
-  int2048 prod = q * b;
-  // compute *this - prod
-  if (this->neg != prod.neg) {
-    *this = add_abs(*this, prod);
-    this->neg = this->neg;
-  } else {
-    int cmp = this->abs_compare(prod);
-    if (cmp == 0) { this->a.clear(); this->neg = false; }
-    else if (cmp > 0) { *this = sub_abs(*this, prod); this->neg = this->neg; }
-    else { *this = sub_abs(prod, *this); this->neg = !prod.neg; }
-  }
-  return *this;
+  // r = x - (x / y) * y with floor division: the sign follows the divisor
+  int2048 q, r;
+  divmod_abs(*this, b, q, r);
+  if (!r.is_zero() && neg != b.neg) r = sub_abs(b, r);
+  bool sign = b.neg;
+  a.swap(r.a); touch();
+  neg = sign && !is_zero(); return *this;
 }
 int2048 operator%(int2048 a, const int2048 &b) { a %= b; return a; }
 
+// gptr/egptr/gbump are protected; naming them through a derived class gives member
+// pointers that apply to any streambuf
+struct int2048::get_area : std::streambuf {
+  static const char *begin(std::streambuf *b) { return (b->*&get_area::gptr)(); }
+  static const char *end(std::streambuf *b) { return (b->*&get_area::egptr)(); }
+  static void bump(std::streambuf *b, int n) { (b->*&get_area::gbump)(n); }
+};
+
+// Straight from the stream buffer: digits go into limbs as they arrive, four to a limb
+// counted from the front, and are realigned to the back at the end. Buffered streams
+// are scanned in place; unbuffered ones (std::cin synced with stdio) a character at a
+// time. A token with anything but a sign and digits is rebuilt as text and handed to
+// read().
 std::istream &operator>>(std::istream &is, int2048 &x) {
-  std::string s; is >> s; x.read(s); return is;
+  std::istream::sentry ok(is); // skips leading whitespace
+  if (!ok) { x = int2048(); return is; } // nothing to read: 0, as from an empty string
+  x.touch();
+  typedef std::char_traits<char> tr;
+  auto space = [](int c) { return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == '\v' || c == '\f'; };
+  std::streambuf *sb = is.rdbuf();
+  int c = sb->sgetc(), sign = 0, cur = 0, cnt = 0;
+  if (c == '+' || c == '-') { sign = c; c = sb->snextc(); }
+  std::vector<int> &g = x.a; // most significant group first for now
+  g.clear();
+  while (c != tr::eof() && c >= '0' && c <= '9') {
+    const char *p = int2048::get_area::begin(sb), *e = int2048::get_area::end(sb), *q = p;
+    if (p == e) { // nothing buffered
+      cur = cur * 10 + (c - '0');
+      if (++cnt == int2048::BASE_DIGS) { g.push_back(cur); cur = cnt = 0; }
+      c = sb->snextc();
+      continue;
+    }
+    for (int hi, lo; q < e && *q >= '0' && *q <= '9'; ++q) {
+      for (; !cnt && e - q >= 8 && int2048::swar_digits(q, hi, lo); q += 8) { g.push_back(hi); g.push_back(lo); }
+      if (q == e || *q < '0' || *q > '9') break;
+      cur = cur * 10 + (*q - '0');
+      if (++cnt == int2048::BASE_DIGS) { g.push_back(cur); cur = cnt = 0; }
+    }
+    int2048::get_area::bump(sb, (int)(q - p));
+    c = sb->sgetc();
+  }
+  if (c != tr::eof() && !space(c)) {
+    std::string s;
+    if (sign) s += (char)sign;
+    s.resize(s.size() + g.size() * int2048::BASE_DIGS + cnt);
+    char *p = &s[sign ? 1 : 0];
+    for (int v : g) {
+      for (int k = int2048::BASE_DIGS - 1; k >= 0; --k, v /= 10) p[k] = char('0' + v % 10);
+      p += int2048::BASE_DIGS;
+    }
+    for (int k = cnt - 1; k >= 0; --k, cur /= 10) p[k] = char('0' + cur % 10);
+    for (; c != tr::eof() && !space(c); c = sb->snextc()) s += (char)c;
+    x.read(s);
+  } else {
+    for (size_t i = 0, j = g.size(); i + 1 < j; ++i, --j) std::swap(g[i], g[j - 1]);
+    if (cnt) { // the last cnt digits: x = x * 10^cnt + cur
+      long long carry = cur, m = cnt == 1 ? 10 : cnt == 2 ? 100 : 1000;
+      for (int &v : g) { long long t = v * m + carry; v = (int)(t % int2048::BASE); carry = t / int2048::BASE; }
+      if (carry) g.push_back((int)carry);
+    }
+    x.neg = sign == '-';
+    x.trim();
+  }
+  if (c == tr::eof()) is.setstate(std::ios::eofbit);
+  return is;
 }
 std::ostream &operator<<(std::ostream &os, const int2048 &x) {
-  if (x.is_zero()) { os << 0; return os; }
-  if (x.neg) os << '-';
-  int i = (int)x.a.size() - 1;
-  os << x.a[i];
-  for (--i; i >= 0; --i) {
-    int v = x.a[i];
-    // pad to BASE_DIGS digits (4)
-    os << (v / 1000);
-    os << ((v / 100) % 10);
-    os << ((v / 10) % 10);
-    os << (v % 10);
-  }
-  return os;
+  if (const std::string *s = x.dec_text()) return os.write(s->data(), s->size());
+  std::string buf(x.dec_len(), '\0');
+  return os.write(buf.data(), x.write_dec(&buf[0]));
 }
 
 bool operator==(const int2048 &x, const int2048 &y) {
@@ -297,4 +1954,281 @@ bool operator>(const int2048 &x, const int2048 &y) { return y < x; }
 bool operator<=(const int2048 &x, const int2048 &y) { return !(y < x); }
 bool operator>=(const int2048 &x, const int2048 &y) { return !(x < y); }
 
+void int2048::cache_decimal(bool on) {
+  if (on && !dec) dec = new std::string;
+  if (!on) { delete dec; dec = nullptr; }
+}
+
+// ===== charconv =====
+size_t to_chars_size(const int2048 &x, int base) {
+  if (base < 2 || base > 62) return 0;
+  if (x.is_zero()) return 1;
+  if (base != 10) {
+    // log_base |x| from the top three limbs; the slack covers their truncation
+    int j = (int)x.a.size() - 1;
+    double top = 0;
+    for (int i = 0; i < 3 && j >= 0; ++i, --j) top = top * int2048::BASE + x.a[j];
+    double lg = (std::log(top) + (j + 1) * std::log((double)int2048::BASE)) / std::log((double)base);
+    return x.neg + (size_t)(lg + 1e-6) + 1;
+  }
+  int top = x.a.back();
+  size_t len = x.neg + int2048::BASE_DIGS * (x.a.size() - 1) + 1;
+  for (; top >= 10; top /= 10) ++len;
+  return len;
+}
+
+to_chars_result to_chars(char *first, char *last, const int2048 &x, int base) {
+  if (base < 2 || base > 62) return {last, std::errc::invalid_argument};
+  if (base == 10 || x.is_zero()) {
+    if ((size_t)(last - first) < to_chars_size(x, 10)) return {last, std::errc::value_too_large};
+    if (const std::string *s = x.dec_text()) {
+      std::memcpy(first, s->data(), s->size());
+      return {first + s->size(), std::errc()};
+    }
+    return {first + x.write_dec(first), std::errc()};
+  }
+  int k, t = int2048::radix_levels(x, base);
+  int2048::radix_word(base, k);
+  std::vector<unsigned char> d((size_t)k << (t + 1));
+  int2048::radix_to_digits(x, base, t, d.data());
+  size_t i = 0;
+  while (!d[i]) ++i;
+  if ((size_t)(last - first) < x.neg + d.size() - i) return {last, std::errc::value_too_large};
+  if (x.neg) *first++ = '-';
+  for (; i < d.size(); ++i) *first++ = int2048::radix_char(d[i], base);
+  return {first, std::errc()};
+}
+
+from_chars_result from_chars(const char *first, const char *last, int2048 &x, int base) {
+  if (base < 2 || base > 62) return {first, std::errc::invalid_argument};
+  const char *p = first;
+  bool neg = p < last && *p == '-';
+  const char *d = p + neg, *e = d;
+  if (base == 10) e = int2048::dec_span(d, last);
+  else while (e < last && int2048::radix_digit(*e, base) >= 0) ++e;
+  if (e == d) return {first, std::errc::invalid_argument};
+  if (base == 10) {
+    x.read(d, e); // digits only, so none of read's junk rules apply
+  } else {
+    std::vector<unsigned char> v(e - d);
+    for (size_t i = 0; i < v.size(); ++i) v[i] = (unsigned char)int2048::radix_digit(d[i], base);
+    x = int2048::radix_from_digits(v.data(), v.size(), base);
+  }
+  x.neg = neg && !x.is_zero();
+  return {e, std::errc()};
+}
+
+// ===== binary form =====
+// 0 "I2KB" | 4 version | 5 flags: 1 negative, 2 big-endian | 6 bytes per limb (2) |
+// 7 decimal digits per limb (4) | 8 limb count, 8 bytes
+void int2048::ser_header(unsigned char *h) const {
+  std::memcpy(h, "I2KB", 4);
+  h[4] = SER_VERSION; h[5] = neg; h[6] = 2; h[7] = BASE_DIGS;
+  unsigned long long n = a.size();
+  for (int i = 0; i < 8; ++i) h[8 + i] = (unsigned char)(n >> (8 * i));
+}
+
+long long int2048::ser_read_header(const unsigned char *h, bool &neg, bool &big) {
+  if (std::memcmp(h, "I2KB", 4) || h[4] != SER_VERSION || (h[5] & ~3) || h[6] != 2 || h[7] != BASE_DIGS) return -1;
+  neg = h[5] & 1; big = h[5] & 2;
+  unsigned long long n = 0;
+  for (int i = 0; i < 8; ++i) n |= (unsigned long long)h[big ? 15 - i : 8 + i] << (8 * i);
+  return n >> 40 ? -1 : (long long)n;
+}
+
+bool int2048::ser_limbs(const unsigned char *p, size_t n, bool big, int *out) {
+  for (size_t i = 0; i < n; ++i, p += 2) {
+    int v = big ? p[0] << 8 | p[1] : p[1] << 8 | p[0];
+    if (v >= BASE) return false;
+    out[i] = v;
+  }
+  return true;
+}
+
+size_t serialized_size(const int2048 &x) { return int2048::SER_HEADER + 2 * x.a.size(); }
+
+to_chars_result serialize(char *first, char *last, const int2048 &x) {
+  size_t need = serialized_size(x);
+  if ((size_t)(last - first) < need) return {last, std::errc::value_too_large};
+  unsigned char *p = (unsigned char *)first;
+  x.ser_header(p);
+  p += int2048::SER_HEADER;
+  for (int v : x.a) { *p++ = (unsigned char)(v & 255); *p++ = (unsigned char)(v >> 8); }
+  return {first + need, std::errc()};
+}
+
+from_chars_result deserialize(const char *first, const char *last, int2048 &x) {
+  const unsigned char *h = (const unsigned char *)first;
+  bool neg, big;
+  long long n;
+  if (last - first < int2048::SER_HEADER || (n = int2048::ser_read_header(h, neg, big)) < 0 ||
+      (last - first - int2048::SER_HEADER) / 2 < n)
+    return {first, std::errc::invalid_argument};
+  std::vector<int> a(n);
+  if (!int2048::ser_limbs(h + int2048::SER_HEADER, n, big, a.data())) return {first, std::errc::invalid_argument};
+  x.a.swap(a); x.neg = neg; x.touch();
+  x.trim();
+  return {first + int2048::SER_HEADER + 2 * n, std::errc()};
+}
+
+std::ostream &serialize(std::ostream &os, const int2048 &x) {
+  std::string buf(serialized_size(x), '\0');
+  serialize(&buf[0], &buf[0] + buf.size(), x);
+  return os.write(buf.data(), buf.size());
+}
+
+// limbs come through a small buffer, so a corrupt count cannot reserve much ahead
+std::istream &deserialize(std::istream &is, int2048 &x) {
+  unsigned char h[int2048::SER_HEADER], buf[4096];
+  bool neg, big;
+  long long n;
+  if (!is.read((char *)h, sizeof h)) return is;
+  if ((n = int2048::ser_read_header(h, neg, big)) < 0) { is.setstate(std::ios::failbit); return is; }
+  std::vector<int> a;
+  while ((long long)a.size() < n) {
+    size_t k = (size_t)std::min(n - (long long)a.size(), (long long)sizeof buf / 2);
+    if (!is.read((char *)buf, 2 * k)) return is;
+    a.resize(a.size() + k);
+    if (!int2048::ser_limbs(buf, k, big, a.data() + a.size() - k)) { is.setstate(std::ios::failbit); return is; }
+  }
+  x.a.swap(a); x.neg = neg; x.touch();
+  x.trim();
+  return is;
+}
+
+from_chars_result load(const char *first, const char *last, int2048 &x) {
+  if (last - first >= 4 && !std::memcmp(first, "I2KB", 4)) return deserialize(first, last, x);
+  const char *p = first;
+  while (p < last && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t' || *p == '\v' || *p == '\f')) ++p;
+  if (last - p > 1 && *p == '+' && p[1] != '-') ++p; // from_chars takes no '+'
+  from_chars_result r = from_chars(p, last, x);
+  if (r.ec != std::errc()) r.ptr = first;
+  return r;
+}
+
+bool load_file(const char *path, int2048 &x) {
+  std::FILE *f = std::fopen(path, "rb");
+  if (!f) return false;
+  std::vector<char> buf(1 << 16);
+  if (std::fseek(f, 0, SEEK_END) == 0) {
+    long sz = std::ftell(f);
+    if (sz >= 0 && (size_t)sz >= buf.size()) buf.resize(sz + 1); // + 1 sees the end in one read
+    std::fseek(f, 0, SEEK_SET);
+  }
+  size_t n = 0;
+  while (size_t k = std::fread(buf.data() + n, 1, buf.size() - n, f)) {
+    n += k;
+    if (n == buf.size()) buf.resize(2 * n);
+  }
+  bool ok = !std::ferror(f);
+  std::fclose(f);
+  return ok && load(buf.data(), buf.data() + n, x).ec == std::errc();
+}
+
+// ===== batch reader =====
+int2048::Reader::Reader(std::FILE *f, size_t chunk) : f(f), buf(chunk < 16 ? 16 : chunk) {}
+
+bool int2048::Reader::next(int2048 &x) {
+  auto space = [](char c) { return c == ' ' || c == '\n' || c == '\r' || c == '\t' || c == '\v' || c == '\f'; };
+  for (;;) {
+    while (pos < len && space(buf[pos])) ++pos;
+    if (pos < len) break;
+    pos = 0;
+    if (!(len = std::fread(buf.data(), 1, buf.size(), f))) return false;
+  }
+  size_t end = pos + (buf[pos] == '-' || buf[pos] == '+');
+  for (;;) {
+    end = int2048::dec_span(buf.data() + end, buf.data() + len) - buf.data();
+    while (end < len && !space(buf[end])) ++end;
+    if (end < len) break;
+    // the token runs off the chunk: move it to the front, growing if it fills the buffer
+    size_t have = len - pos;
+    std::memmove(buf.data(), buf.data() + pos, have);
+    if (have == buf.size()) buf.resize(2 * buf.size());
+    pos = 0; end = have;
+    size_t k = std::fread(buf.data() + have, 1, buf.size() - have, f);
+    len = have + k;
+    if (!k) break;
+  }
+  x.read(buf.data() + pos, buf.data() + end);
+  pos = end;
+  return true;
+}
+
+// ===== accumulator =====
+long long int2048::Accumulator::carry(std::vector<long long> &l) {
+  long long c = 0;
+  for (size_t i = 0; i < l.size(); ++i) {
+    long long v = l[i] + c;
+    c = v / BASE; v %= BASE;
+    if (v < 0) { v += BASE; --c; }
+    l[i] = v;
+  }
+  return c;
+}
+
+long long *int2048::Accumulator::room(size_t n, long long w) {
+  if ((adds += w) > ACC_LIMIT) {
+    // the carry out becomes a new signed top lane
+    long long c = carry(lane);
+    if (c) lane.push_back(c);
+    adds = w;
+  }
+  if (lane.size() < n) lane.resize(n, 0);
+  return lane.data();
+}
+
+void int2048::Accumulator::add(const int2048 &x, bool sub) {
+  if (x.is_zero()) return;
+  size_t n = x.a.size();
+  long long *l = room(n, 1);
+  const int *p = x.a.data();
+  if (x.neg != sub) {
+    for (size_t i = 0; i < n; ++i) l[i] -= p[i];
+  } else {
+    for (size_t i = 0; i < n; ++i) l[i] += p[i];
+  }
+}
+
+void int2048::Accumulator::add_product(const int2048 &x, const int2048 &y, bool sub) {
+  if (x.is_zero() || y.is_zero()) return;
+  const int2048 *u = &x, *v = &y;
+  if (u->a.size() > v->a.size()) std::swap(u, v);
+  if ((int)u->a.size() >= KARA_MIN) { add(mul_abs(x, y), sub != (x.neg != y.neg)); return; }
+  // each row adds at most BASE^2 per lane
+  size_t nu = u->a.size(), nv = v->a.size();
+  long long *l = room(nu + nv - 1, (long long)nu * BASE);
+  long long s = sub != (x.neg != y.neg) ? -1 : 1;
+  const int *w = v->a.data();
+  for (size_t i = 0; i < nu; ++i) {
+    long long m = s * u->a[i], *li = l + i;
+    for (size_t j = 0; j < nv; ++j) li[j] += m * w[j];
+  }
+}
+
+int2048::Accumulator &int2048::Accumulator::operator+=(const int2048 &x) { add(x, false); return *this; }
+int2048::Accumulator &int2048::Accumulator::operator-=(const int2048 &x) { add(x, true); return *this; }
+int2048::Accumulator &int2048::Accumulator::addmul(const int2048 &x, const int2048 &y) { add_product(x, y, false); return *this; }
+int2048::Accumulator &int2048::Accumulator::submul(const int2048 &x, const int2048 &y) { add_product(x, y, true); return *this; }
+
+int2048 int2048::Accumulator::value() const {
+  // sum = hi * BASE^n + lo, lo carried straight out of the lanes
+  int2048 lo;
+  lo.a.resize(lane.size());
+  long long c = 0;
+  for (size_t i = 0; i < lane.size(); ++i) {
+    long long v = lane[i] + c;
+    c = v / BASE; v %= BASE;
+    if (v < 0) { v += BASE; --c; }
+    lo.a[i] = (int)v;
+  }
+  lo.trim();
+  if (!c) return lo;
+  int2048 hi(c);
+  hi.shift_limbs((long long)lane.size());
+  return hi + lo;
+}
+
+void int2048::Accumulator::clear() { lane.clear(); adds = 0; }
+
 } // namespace sjtu
@@ -0,0 +1,35 @@
+// mullo / mulhi past 2^MUL_SSA_LOG columns, where the column kernels hand over to
+// mul_abs instead of running a transform too long for doubles. x = 10^24000000 - 1
+// is six million limbs of 9999, the worst case for rounding.
+// g++ -std=c++20 -O2 -Isrc/include tests/conv_ssa.cpp src/int2048.cpp && ./a.out
+#include <string>
+
+#include "int2048.h"
+
+using sjtu::int2048;
+
+static int failures = 0;
+
+static void check(const char *what, const int2048 &got, const int2048 &want) {
+  if (got != want) {
+    std::cout << "FAIL " << what << "\n";
+    ++failures;
+  }
+}
+
+int main() {
+  int2048 x(std::string(24000000, '9'));
+  int2048 p = x * x;
+  int n = 2 * 6000000 - 3;
+  int2048 top = p;
+  top.shift_limbs(-n);
+  int2048 low = top;
+  low.shift_limbs(n);
+  check("mullo", mullo(x, x, n), p - low);
+  check("mulhi", mulhi(x, x, n), top);
+  int2048 hi3 = p;
+  hi3.shift_limbs(-3);
+  check("mulhi low cut", mulhi(x, x, 3), hi3);
+  if (!failures) std::cout << "ok\n";
+  return failures != 0;
+}
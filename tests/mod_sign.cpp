@@ -0,0 +1,37 @@
+// x % y = x - (x / y) * y with floor division, so a nonzero remainder takes the
+// sign of y, including when both operands are negative.
+// g++ -std=c++20 -Isrc/include tests/mod_sign.cpp src/int2048.cpp && ./a.out
+#include <string>
+
+#include "int2048.h"
+
+using sjtu::int2048;
+
+static int failures = 0;
+
+static void check(const int2048 &x, const int2048 &y, const int2048 &want) {
+  int2048 r = x % y, q = x / y;
+  if (r != want || q * y + r != x) {
+    std::cout << "FAIL " << x << " % " << y << " = " << r << ", want " << want << "\n";
+    ++failures;
+  }
+}
+
+int main() {
+  long long v[] = {0, 3, 5, 7, 10, 9999, 10000, 123456789};
+  for (long long a : v)
+    for (long long b : v) {
+      if (!b) continue;
+      for (int s = 0; s < 4; ++s) {
+        long long x = s & 1 ? -a : a, y = s & 2 ? -b : b, r = x % y;
+        if (r && (r < 0) != (y < 0)) r += y;
+        check(int2048(x), int2048(y), int2048(r));
+      }
+    }
+  // multi-limb operands, both negative
+  int2048 x("-123456789012345678901234567890"), y("-98765432109876543210");
+  check(x, y, int2048("-60185185207253086410"));
+  check(y, x, y);
+  if (!failures) std::cout << "ok\n";
+  return failures != 0;
+}
@@ -0,0 +1,59 @@
+// mullo / mulhi against the full product from operator*, truncated or shifted, at
+// operand sizes in each multiplication tier: schoolbook, Karatsuba, FFT and past the
+// Schonhage-Strassen cutover. Random and all-9999 operands, squares included.
+// g++ -std=c++20 -O2 -Isrc/include tests/mullo_mulhi.cpp src/int2048.cpp && ./a.out
+#include <string>
+
+#include "int2048.h"
+
+using sjtu::int2048;
+
+static int failures = 0;
+static unsigned long long seed = 88172645463325252ull;
+
+// d digits, leading digit nonzero
+static int2048 random_number(int d) {
+  std::string s(d, '0');
+  for (char &c : s) {
+    seed ^= seed << 13; seed ^= seed >> 7; seed ^= seed << 17;
+    c = (char)('0' + seed % 10);
+  }
+  if (s[0] == '0') s[0] = '1';
+  return int2048(s);
+}
+
+static void check(const int2048 &x, const int2048 &y, int n, const char *what) {
+  int2048 p = x * y, hi = p;
+  hi.shift_limbs(-n);
+  int2048 lo = hi;
+  lo.shift_limbs(n);
+  lo = p - lo;
+  if (mullo(x, y, n) != lo || mulhi(x, y, n) != hi) {
+    std::cout << "FAIL " << what << ", n = " << n << "\n";
+    ++failures;
+  }
+}
+
+static void check_sizes(int dx, int dy, int cuts) {
+  int2048 nines_x(std::string(dx, '9')), nines_y(std::string(dy, '9'));
+  int2048 x = random_number(dx), y = random_number(dy);
+  int lx = (dx + 3) / 4, ly = (dy + 3) / 4;
+  std::string size = std::to_string(dx) + " x " + std::to_string(dy) + " digits";
+  for (int i = 0; i <= cuts; ++i) {
+    int n = (int)((long long)(lx + ly + 1) * i / cuts);
+    check(x, y, n, ("random " + size).c_str());
+    check(x, x, n, ("square " + size).c_str());
+    check(nines_x, nines_y, n, ("all nines " + size).c_str());
+  }
+}
+
+int main() {
+  check_sizes(1, 1, 3);
+  check_sizes(90, 70, 20);         // schoolbook
+  check_sizes(300, 200, 20);       // Karatsuba
+  check_sizes(2000, 1500, 10);     // FFT
+  check_sizes(60000, 9000, 10);
+  check_sizes(4400000, 4400000, 2); // 2.2M product limbs, past 2^MUL_SSA_LOG
+  if (!failures) std::cout << "ok\n";
+  return failures != 0;
+}